@@ -80,13 +80,15 @@ namespace fhatos {
               ->display_reset_reason()
               ->display_architecture();
         }
+        // kernel heaps share their objs (copy-on-write) unless --heap:share=false
+        const Rec_p kernel_heap_config = Obj::to_rec({{"share", dool(args_parser->option_bool("--heap:share", true))}});
         kp->display_note("!ymounting !bkernel !ystructures!!")
             ->display_memory()
             ->mount(Heap<>::create("/mnt/#"))
-            ->mount(Heap<>::create("/sys/#", id_p("/mnt/sys")))
+            ->mount(Heap<>::create("/sys/#", id_p("/mnt/sys"), kernel_heap_config))
             ->mount(Heap<>::create("/boot/#", id_p("/mnt/boot")))
-            ->mount(Heap<>::create("/fos/#", id_p("/mnt/fos")))
-            ->mount(Heap<>::create("/mmadt/#", id_p("/mnt/mmadt")))
+            ->mount(Heap<>::create("/fos/#", id_p("/mnt/fos"), kernel_heap_config))
+            ->mount(Heap<>::create("/mmadt/#", id_p("/mnt/mmadt"), kernel_heap_config))
             ->using_boot_config(args_parser->option_furi("--boot:config", "/boot/boot_config.obj"));
         //////////////////////////////////////////////////////////////////
         //////////////////////////////////////////////////////////////////
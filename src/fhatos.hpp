@@ -183,6 +183,11 @@ namespace fhatos {
   using uint = unsigned int;
   [[maybe_unused]] static const char *EMPTY_CHARS = "";
 
+  /// mix a value's hash into a running seed (boost::hash_combine)
+  inline size_t hash_combine(const size_t seed, const size_t value) {
+    return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+  }
+
   ////////////
   // MACROS //
   ////////////
@@ -195,6 +200,12 @@ namespace fhatos {
 #ifndef FOS_INT_TYPE
 #define FOS_INT_TYPE int32_t
 #endif
+#ifndef FOS_INT_CACHE_MIN
+#define FOS_INT_CACHE_MIN -128
+#endif
+#ifndef FOS_INT_CACHE_MAX
+#define FOS_INT_CACHE_MAX 1024
+#endif
 #ifndef FOS_STR_ENCODING
 #define FOS_STR_ENCODING sizeof(std::string::value_type)
 #endif
@@ -341,5 +352,19 @@ namespace fhatos {
    * The default value is set to `true`.
    */
   inline bool BOOTING = true;
+
+  /// monotonic per-thread counters of the runtime's hot operations (a profile takes their deltas)
+  struct ProfileCounters {
+    uint64_t allocations = 0;
+    uint64_t frame_pushes = 0;
+    uint64_t type_checks = 0;
+    uint64_t type_check_ns = 0;
+    /// domain checks skipped as proven by type inference
+    uint64_t type_checks_elided = 0;
+    /// time the (outermost) type checks
+    bool timing = false;
+  };
+
+  inline thread_local ProfileCounters PROFILE_COUNTERS;
 } // namespace fhatos
 #endif
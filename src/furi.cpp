@@ -1022,6 +1022,20 @@ namespace fhatos {
            StringHelper::char_ptr_equal(this->user_, other.user_) &&
            StringHelper::char_ptr_equal(this->password_, other.password_);
   }
+  size_t fURI::hash() const {
+    size_t h = std::hash<uint8_t>{}(this->path_length_);
+    for(int i = 0; i < this->path_length_; i++) {
+      h = hash_combine(h, std::hash<std::string_view>{}(this->path_[i]));
+    }
+    if(!this->empty())
+      h = hash_combine(h, (this->sprefix_ ? 1 : 0) | (this->spostfix_ ? 2 : 0));
+    if(this->scheme_)
+      h = hash_combine(h, std::hash<std::string_view>{}(this->scheme_));
+    if(this->host_)
+      h = hash_combine(h, std::hash<std::string_view>{}(this->host_));
+    return hash_combine(h, this->port_);
+  }
+
   string fURI::toString() const {
     string uri;
     if(this->scheme_)
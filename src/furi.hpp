@@ -290,6 +290,9 @@ namespace fhatos {
 
     [[nodiscard]] bool equals(const fURI &other) const;
 
+    /// structural hash over the query-less components (equal furis hash equal)
+    [[nodiscard]] size_t hash() const;
+
     [[nodiscard]] string toString() const;
 
   private:
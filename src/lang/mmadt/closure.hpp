@@ -0,0 +1,151 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#pragma once
+#ifndef fhatos_closure_hpp
+#define fhatos_closure_hpp
+
+#include "../../fhatos.hpp"
+#include "../obj.hpp"
+#include "compiler.hpp"
+
+namespace fhatos {
+  /// code compiled to a chain of the C++ functions its insts resolve to (for code applied over and over, e.g. loops)
+  /// a step is specialized to the first base type (and value id) it sees: its inst is resolved and its domain
+  /// checked once, and later objs of that type call the resolved function directly (no resolution, type checks,
+  /// frame, or arg copy). a step whose lhs is another type runs in the interpreter as does a step that isn't a
+  /// builtin cpp inst with value args. a scatter or a gather hands the rest of the code to the processor.
+  /// steps respecialize when insts or types have been redefined. a closure isn't thread safe.
+  class Closure {
+    struct Step {
+      Inst_p inst;
+      /// the rest of the code (from this step) as run by the interpreter
+      BCode_p rest;
+      bool gather = false;
+      /// never specialized (not a builtin cpp inst with value args)
+      bool interpreted = false;
+      // the specialization
+      Cpp_p function = nullptr;
+      InstArgs args = nullptr;
+      OType otype = OType::NOOBJ;
+      ID_p tid = nullptr;
+      ID_p vid = nullptr;
+      long epoch = -1;
+    };
+
+    const Obj_p code_;
+    List<Step> steps_;
+    long calls_ = 0;
+    long deopts_ = 0;
+
+    static bool base_type(const Obj_p &obj) {
+      const auto it = OTYPE_FURI.find(obj->otype);
+      return it != OTYPE_FURI.end() && obj->tid->equals(*it->second);
+    }
+
+    [[nodiscard]] bool guard(const Step &step, const Obj_p &obj, const long epoch) const {
+      return step.function && step.epoch == epoch && step.otype == obj->otype && step.tid->equals(*obj->tid) &&
+             (step.vid ? obj->vid && step.vid->equals(*obj->vid) : !obj->vid);
+    }
+
+    /// resolve the step's inst for the obj's type (false if the obj must go through the interpreter)
+    bool specialize(Step *step, const Obj_p &obj, const long epoch) const {
+      if(step->interpreted || obj->is_poly() || !base_type(obj))
+        return false;
+      const Inst_p resolved = Compiler().resolve_inst(obj, step->inst);
+      if(!resolved->tid->starts_with(MMADT_SCHEME "/") || !std::holds_alternative<Cpp_p>(resolved->inst_f()) ||
+         resolved->is_gather() || "frame" == resolved->inst_op()) {
+        step->interpreted = true;
+        return false;
+      }
+      // the domain of a base type is checked once (the interpreter raises the error of a failed check)
+      if(!Compiler(false).type_check(obj, *resolved->domain()))
+        return false;
+      step->function = std::get<Cpp_p>(resolved->inst_f());
+      step->args = resolved->inst_args();
+      step->otype = obj->otype;
+      step->tid = obj->tid;
+      step->vid = obj->vid;
+      step->epoch = epoch;
+      return true;
+    }
+
+  public:
+    explicit Closure(const Obj_p &code) : code_(code) {
+      const InstList_p insts = code->is_inst() ? make_shared<InstList>(InstList{code}) : code->bcode_value();
+      for(size_t i = 0; i < insts->size(); i++) {
+        Step step;
+        step.inst = insts->at(i);
+        step.rest = Obj::to_bcode(InstList(insts->begin() + i, insts->end()));
+        try {
+          step.gather = TYPE_INST_RESOLVER(Obj::to_type(OBJ_FURI), step.inst)->is_gather();
+        } catch(const fError &) {
+          // resolved as the processor resolves its barriers
+        }
+        // args that are code are evaluated against each lhs
+        step.interpreted = !step.inst->is_inst() || step.inst->vid;
+        for(const auto &[k, v]: *step.inst->inst_args()->rec_value()) {
+          step.interpreted = step.interpreted || v->is_code();
+        }
+        this->steps_.push_back(step);
+      }
+    }
+
+    Obj_p apply(const Obj_p &lhs) {
+      ++this->calls_;
+      if(this->steps_.empty())
+        return lhs;
+      // code is processed over each of an objs' objs and code from noobj starts itself (see Obj::apply())
+      if(lhs->is_objs() || lhs->is_noobj() || lhs->is_type()) {
+        ++this->deopts_;
+        return this->code_->apply(lhs);
+      }
+      const long epoch = Compiler::inst_cache_epoch();
+      Obj_p obj = lhs;
+      for(size_t i = 0; i < this->steps_.size(); i++) {
+        Step &step = this->steps_.at(i);
+        if(step.gather) {
+          ++this->deopts_;
+          return step.rest->apply(obj->is_objs() ? obj : Obj::to_objs({obj}));
+        }
+        if(this->guard(step, obj, epoch) || this->specialize(&step, obj, epoch))
+          obj = (*step.function)(obj, step.args);
+        else {
+          ++this->deopts_;
+          obj = step.inst->apply(obj);
+        }
+        if(obj->is_objs() && i + 1 < this->steps_.size()) {
+          ++this->deopts_;
+          return this->steps_.at(i + 1).rest->apply(obj);
+        }
+      }
+      return obj;
+    }
+
+    /// the steps, how many are specialized, and how often objs took the interpreter
+    [[nodiscard]] Rec_p stats() const {
+      const long epoch = Compiler::inst_cache_epoch();
+      const long native = std::count_if(this->steps_.begin(), this->steps_.end(),
+                                        [epoch](const Step &step) { return step.function && step.epoch == epoch; });
+      return Obj::to_rec({{"steps", jnt(static_cast<FOS_INT_TYPE>(this->steps_.size()))},
+                          {"native", jnt(static_cast<FOS_INT_TYPE>(native))},
+                          {"calls", jnt(static_cast<FOS_INT_TYPE>(this->calls_))},
+                          {"deopts", jnt(static_cast<FOS_INT_TYPE>(this->deopts_))}});
+    }
+  };
+} // namespace fhatos
+#endif
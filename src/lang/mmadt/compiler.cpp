@@ -17,6 +17,10 @@ FhatOS: A Distributed Operating System
  ******************************************************************************/
 
 #include "compiler.hpp"
+#include <chrono>
+#include <utility>
+#include <unordered_map>
+#include <unordered_set>
 #include "../../model/fos/sys/router/router.hpp"
 #include "../../model/fos/util/log.hpp"
 #include "../../util/obj_helper.hpp"
@@ -95,6 +99,277 @@ namespace fhatos {
     }
   }
 
+  ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////// INST CACHE //////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// resolved (pre-merge) insts keyed by lhs otype/tid/vid, inst tid, and inst arg shape
+  class InstCache {
+  public:
+    struct Entry {
+      OType otype;
+      ID lhs_tid;
+      ID_p lhs_vid;
+      ID inst_tid;
+      Inst_p resolved;
+      vector<ID_p> guards;
+    };
+
+    Mutex mutex;
+    std::unordered_map<size_t, Entry> entries;
+    std::unordered_set<size_t> lhs_tids;
+    std::atomic<long> hits{0};
+    std::atomic<long> misses{0};
+    std::atomic<long> invalidations{0};
+    /// bumped by every write that could change an inst resolution (whether or not entries were cached)
+    std::atomic<long> epoch{0};
+
+    static InstCache *singleton() {
+      static InstCache cache;
+      return &cache;
+    }
+
+    /// only stubs are resolved (poly fields and inst vids are read from anywhere and booting types are unchecked)
+    static bool cacheable(const Obj_p &lhs, const Inst_p &inst) {
+      return !BOOTING && inst->is_inst_stub() && !inst->vid && !lhs->is_poly() && !lhs->is_objs();
+    }
+
+    static size_t key(const Obj_p &lhs, const Inst_p &inst) {
+      size_t seed = static_cast<size_t>(lhs->otype);
+      seed = hash_combine(seed, lhs->tid->hash());
+      seed = hash_combine(seed, lhs->vid ? lhs->vid->hash() : 0);
+      seed = hash_combine(seed, inst->tid->hash());
+      for(const auto &[k, v]: *inst->inst_args()->rec_value()) {
+        seed = hash_combine(seed, k->hash());
+        seed = hash_combine(seed, static_cast<size_t>(v->otype));
+      }
+      return seed;
+    }
+
+    Inst_p get(const size_t key, const Obj_p &lhs, const Inst_p &inst, vector<ID_p> *guards) {
+      auto lock = shared_lock<Mutex>(this->mutex);
+      const auto it = this->entries.find(key);
+      if(it == this->entries.end())
+        return nullptr;
+      const Entry &entry = it->second;
+      if(entry.otype != lhs->otype || !entry.lhs_tid.equals(*lhs->tid) || !entry.inst_tid.equals(*inst->tid) ||
+         (entry.lhs_vid ? !lhs->vid || !entry.lhs_vid->equals(*lhs->vid) : nullptr != lhs->vid))
+        return nullptr;
+      *guards = entry.guards;
+      return entry.resolved;
+    }
+
+    void put(const size_t key, const Obj_p &lhs, const Inst_p &inst, const Inst_p &resolved,
+             const vector<ID_p> &guards) {
+      auto lock = std::lock_guard<Mutex>(this->mutex);
+      if(this->entries.size() >= FOS_INST_CACHE_SIZE) {
+        this->entries.clear();
+        this->lhs_tids.clear();
+      }
+      this->entries.insert_or_assign(key, Entry{lhs->otype, *lhs->tid, lhs->vid, *inst->tid, resolved, guards});
+      this->lhs_tids.insert(lhs->tid->no_query().hash());
+    }
+
+    void clear() {
+      auto lock = std::lock_guard<Mutex>(this->mutex);
+      if(!this->entries.empty()) {
+        this->entries.clear();
+        this->lhs_tids.clear();
+        ++this->invalidations;
+      }
+    }
+  };
+
+  void Compiler::inst_cache_invalidate(const fURI &furi, const Obj_p &obj) {
+    InstCache *cache = InstCache::singleton();
+    {
+      auto lock = shared_lock<Mutex>(cache->mutex);
+      // inst/type namespaces, components (obj::inst), code anywhere, deletes, and redefinitions of cached types
+      if(!furi.has_components() && !obj->is_code() && !obj->is_noobj() && !furi.matches(MMADT_URI "/#") &&
+         !furi.matches(FOS_URI "/#") && !cache->lhs_tids.count(furi.no_query().hash()))
+        return;
+    }
+    ++cache->epoch;
+    cache->clear();
+  }
+
+  void Compiler::inst_cache_clear() {
+    ++InstCache::singleton()->epoch;
+    InstCache::singleton()->clear();
+  }
+
+  long Compiler::inst_cache_epoch() { return InstCache::singleton()->epoch.load(); }
+
+  Obj_p Compiler::inst_cache_stats() {
+    InstCache *cache = InstCache::singleton();
+    long size;
+    {
+      auto lock = shared_lock<Mutex>(cache->mutex);
+      size = cache->entries.size();
+    }
+    return Obj::to_rec({{"size", jnt(size)},
+                        {"hits", jnt(cache->hits.load())},
+                        {"misses", jnt(cache->misses.load())},
+                        {"invalidations", jnt(cache->invalidations.load())}});
+  }
+
+  ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  ///////////////////////////////////////////////// TYPE CACHE //////////////////////////////////////////////////////
+  ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  /// set by a type check that consulted a definition whose checks can't be cached (nor can the checks enclosing it)
+  thread_local bool TYPE_CHECK_IMPURE = false;
+
+  /// type definitions (read once) and type check results keyed by obj structure, obj tid, and type id
+  class TypeCache {
+  public:
+    struct Definition {
+      fURI type_id;
+      Obj_p type;
+      /// a check against the definition depends only on the checked obj
+      bool pure;
+    };
+
+    struct Entry {
+      OType otype;
+      ID obj_tid;
+      ID type_id;
+      long version;
+      bool checked;
+    };
+
+    Mutex mutex;
+    std::unordered_map<size_t, Definition> definitions;
+    std::unordered_map<size_t, Entry> entries;
+    std::atomic<long> hits{0};
+    std::atomic<long> misses{0};
+    std::atomic<long> invalidations{0};
+    /// bumped by every write that could redefine a type (entries of an older version are misses)
+    std::atomic<long> version{0};
+
+    static TypeCache *singleton() {
+      static TypeCache cache;
+      return &cache;
+    }
+
+    /// the obj of a value id can change behind it
+    static bool cacheable(const Obj *obj) { return !BOOTING && !obj->vid && !obj->is_objs(); }
+
+    /// code whose args are values (or such code) checks an obj the same way every time (a uri arg is read from)
+    static bool pure(const Obj_p &type) {
+      if(type->is_code()) {
+        const InstList_p insts = type->is_inst() ? make_shared<InstList>(InstList{type}) : type->bcode_value();
+        for(const Inst_p &inst: *insts) {
+          if(!inst->is_inst())
+            continue;
+          for(const auto &[k, v]: *inst->inst_args()->rec_value()) {
+            if(v->is_uri() || !TypeCache::pure(v))
+              return false;
+          }
+        }
+      } else if(type->is_rec()) {
+        for(const auto &[k, v]: *type->rec_value()) {
+          if(!TypeCache::pure(k) || !TypeCache::pure(v))
+            return false;
+        }
+      } else if(type->is_lst()) {
+        for(const Obj_p &e: *type->lst_value()) {
+          if(!TypeCache::pure(e))
+            return false;
+        }
+      }
+      return true;
+    }
+
+    static size_t key(const Obj *obj, const ID &type_id) {
+      return hash_combine(hash_combine(obj->hash(), obj->tid->hash()), type_id.hash());
+    }
+
+    Definition definition(const fURI &type_id) {
+      const size_t key = type_id.hash();
+      {
+        auto lock = shared_lock<Mutex>(this->mutex);
+        if(const auto it = this->definitions.find(key); it != this->definitions.end() && it->second.type_id.equals(type_id))
+          return it->second;
+      }
+      const long read_version = this->version.load();
+      const Obj_p type = ROUTER_READ(type_id);
+      Definition definition = {type_id, type, TypeCache::pure(type)};
+      if(!BOOTING) {
+        auto lock = std::lock_guard<Mutex>(this->mutex);
+        if(read_version == this->version.load()) {
+          if(this->definitions.size() >= FOS_TYPE_CACHE_SIZE)
+            this->definitions.clear();
+          this->definitions.insert_or_assign(key, definition);
+        }
+      }
+      return definition;
+    }
+
+    Option<bool> get(const size_t key, const Obj *obj, const ID &type_id) {
+      auto lock = shared_lock<Mutex>(this->mutex);
+      const auto it = this->entries.find(key);
+      if(it == this->entries.end() || it->second.version != this->version.load() || it->second.otype != obj->otype ||
+         !it->second.obj_tid.equals(*obj->tid) || !it->second.type_id.equals(type_id)) {
+        ++this->misses;
+        return {};
+      }
+      ++this->hits;
+      return it->second.checked;
+    }
+
+    void put(const size_t key, const Obj *obj, const ID &type_id, const bool checked, const long read_version) {
+      auto lock = std::lock_guard<Mutex>(this->mutex);
+      if(read_version != this->version.load())
+        return;
+      if(this->entries.size() >= FOS_TYPE_CACHE_SIZE)
+        this->entries.clear();
+      this->entries.insert_or_assign(key, Entry{obj->otype, *obj->tid, type_id, read_version, checked});
+    }
+
+    void clear() {
+      auto lock = std::lock_guard<Mutex>(this->mutex);
+      ++this->version;
+      if(!this->entries.empty() || !this->definitions.empty()) {
+        this->entries.clear();
+        this->definitions.clear();
+        ++this->invalidations;
+      }
+    }
+  };
+
+  Obj_p Compiler::type_definition(const fURI &type_id) { return TypeCache::singleton()->definition(type_id).type; }
+
+  void Compiler::type_cache_invalidate(const fURI &furi, const Obj_p &obj) {
+    TypeCache *cache = TypeCache::singleton();
+    {
+      auto lock = shared_lock<Mutex>(cache->mutex);
+      // type namespaces, components, code anywhere, and redefinitions of read types
+      if(!furi.has_components() && !obj->is_code() && !furi.matches(MMADT_URI "/#") && !furi.matches(FOS_URI "/#") &&
+         !cache->definitions.count(furi.no_query().hash()))
+        return;
+    }
+    cache->clear();
+  }
+
+  void Compiler::type_cache_clear() { TypeCache::singleton()->clear(); }
+
+  Obj_p Compiler::type_cache_stats() {
+    TypeCache *cache = TypeCache::singleton();
+    long size;
+    long definitions;
+    {
+      auto lock = shared_lock<Mutex>(cache->mutex);
+      size = cache->entries.size();
+      definitions = cache->definitions.size();
+    }
+    return Obj::to_rec({{"size", jnt(size)},
+                        {"definitions", jnt(definitions)},
+                        {"hits", jnt(cache->hits.load())},
+                        {"misses", jnt(cache->misses.load())},
+                        {"invalidations", jnt(cache->invalidations.load())}});
+  }
+
   bool match_inst_args(const InstArgs &provided_inst, const InstArgs &resolved_inst) {
     for(const auto &[kb, vb]: *resolved_inst->rec_value()) {
       bool found = false;
@@ -120,8 +395,22 @@ namespace fhatos {
     if(resolved_inst->is_noobj())
       return Obj::to_noobj();
     // TODO: obj{*} fails tests (fix)
-    if(!resolved_inst->is_gather() && !Compiler(false).type_check(lhs, *resolved_inst->domain()))
-      return Obj::to_noobj();
+    if(!resolved_inst->is_gather()) {
+      const ID_p domain = resolved_inst->domain();
+      const bool typed = Compiler(false).type_check(lhs, *domain);
+      if(lhs.get() == this->cache_lhs_) {
+        // a value-dependent rejection means another obj of the same type may resolve differently
+        if(!typed)
+          this->cache_unsafe_ = true;
+        else if(!domain->equals(*OBJ_FURI))
+          this->cache_guards_.push_back(domain);
+      }
+      if(!typed)
+        return Obj::to_noobj();
+    }
+    // code-based insts carry the provided inst args (which are not part of the cache key)
+    if(lhs.get() == this->cache_lhs_ && !resolved_inst->is_inst())
+      this->cache_unsafe_ = true;
     Inst_p resolved = Obj::to_inst(
         InstValue(resolved_inst->is_inst() ? resolved_inst->inst_args() : provided_inst->inst_args(), // args
                   resolved_inst->is_inst() ? resolved_inst->inst_f() : resolved_inst, // inst_f
@@ -141,7 +430,38 @@ namespace fhatos {
       return inst;
     // if(!lhs->is_noobj() && !this->coefficient_check(lhs->range_coefficient(), inst->domain_coefficient()))
     // return Obj::to_noobj();
+    // only the outermost resolution of a cacheable lhs consults the inst cache
+    if(this->cache_lhs_ || this->dt || !InstCache::cacheable(lhs, inst)) {
+      const Inst_p inst_obj = this->resolve_inst_obj(lhs, inst);
+      return inst_obj->is_inst() ? this->merge_inst(lhs, inst, inst_obj) : inst;
+    }
+    InstCache *cache = InstCache::singleton();
+    const size_t key = InstCache::key(lhs, inst);
+    if(vector<ID_p> guards; const Inst_p cached = cache->get(key, lhs, inst, &guards)) {
+      if(std::all_of(guards.begin(), guards.end(),
+                     [&lhs](const ID_p &domain) { return Compiler(false).type_check(lhs, *domain); })) {
+        ++cache->hits;
+        return this->merge_inst(lhs, inst, cached);
+      }
+    }
+    ++cache->misses;
+    this->cache_lhs_ = lhs.get();
+    this->cache_unsafe_ = false;
+    this->cache_guards_.clear();
+    Inst_p inst_obj;
+    try {
+      inst_obj = this->resolve_inst_obj(lhs, inst);
+    } catch(const std::exception &) {
+      this->cache_lhs_ = nullptr;
+      throw;
+    }
+    this->cache_lhs_ = nullptr;
+    if(!this->cache_unsafe_ && !inst_obj->is_inst_stub())
+      cache->put(key, lhs, inst, inst_obj, this->cache_guards_);
+    return inst_obj->is_inst() ? this->merge_inst(lhs, inst, inst_obj) : inst;
+  }
 
+  Inst_p Compiler::resolve_inst_obj(const Obj_p &lhs, const Inst_p &inst) const {
     Obj_p inst_obj = mmADT::resolve(lhs, inst);
     if(!inst_obj->is_noobj())
       inst_obj = convert_to_inst(lhs, inst, inst_obj);
@@ -223,7 +543,7 @@ namespace fhatos {
                      derivation_string.c_str());
       }
     }
-    return inst_obj->is_inst() ? this->merge_inst(lhs, inst, inst_obj) : inst;
+    return inst_obj;
   }
 
   bool Compiler::in_block_list(const string &op) {
@@ -335,10 +655,51 @@ namespace fhatos {
   bool Compiler::type_check(const Obj *obj, const ID &type_id) const {
     if(BOOTING)
       return true;
+    if(PROFILE_COUNTERS.timing) {
+      PROFILE_COUNTERS.timing = false;
+      const auto start = std::chrono::steady_clock::now();
+      const bool checked = this->type_check(obj, type_id);
+      PROFILE_COUNTERS.type_check_ns +=
+          std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+      PROFILE_COUNTERS.timing = true;
+      return checked;
+    }
+    ++PROFILE_COUNTERS.type_checks;
     // don't type check code yet -- this needs to be thought through more carefully as to the definition of code
     // equivalence
     if(obj->otype == OType::TYPE || obj->otype == OType::INST || obj->otype == OType::BCODE)
       return true;
+    // a base type (or obj) check is cheaper than its lookup (a rec's typed fields are checked below)
+    if(!obj->is_rec() && !obj->is_noobj()) {
+      if(const fURI type_no_query_id = type_id.no_query();
+         type_no_query_id.equals(*OBJ_FURI) || type_no_query_id.equals(*NOOBJ_FURI) ||
+         type_no_query_id.equals(*OTYPE_FURI.at(obj->otype)))
+        return true;
+    }
+    TypeCache *cache = TypeCache::singleton();
+    const bool cacheable = TypeCache::cacheable(obj);
+    const size_t key = cacheable ? TypeCache::key(obj, type_id) : 0;
+    if(cacheable) {
+      // a failed check is repeated when its error is to be thrown
+      if(const Option<bool> checked = cache->get(key, obj, type_id); checked && (checked.value() || !this->throw_on_miss))
+        return checked.value();
+    }
+    const long read_version = cache->version.load();
+    const bool impure = std::exchange(TYPE_CHECK_IMPURE, false);
+    bool checked;
+    try {
+      checked = this->type_check_obj(obj, type_id);
+    } catch(const fError &) {
+      TYPE_CHECK_IMPURE = impure || TYPE_CHECK_IMPURE;
+      throw;
+    }
+    if(cacheable && !TYPE_CHECK_IMPURE)
+      cache->put(key, obj, type_id, checked, read_version);
+    TYPE_CHECK_IMPURE = impure || TYPE_CHECK_IMPURE;
+    return checked;
+  }
+
+  bool Compiler::type_check_obj(const Obj *obj, const ID &type_id) const {
     // if(obj->is_inst())
     // return this->type_check(Router::singleton()->read(*obj->range()),type_id);
     if(obj->is_noobj()) {
@@ -365,7 +726,9 @@ namespace fhatos {
     //   return true;
     if(type_no_query_id.equals(*NOOBJ_FURI) && (obj->otype == OType::NOOBJ || obj->tid->equals(*OBJ_FURI)))
       return true;
-    if(const Obj_p type = Router::singleton()->read(type_no_query_id); !type->is_noobj()) {
+    const TypeCache::Definition definition = TypeCache::singleton()->definition(type_no_query_id);
+    TYPE_CHECK_IMPURE = TYPE_CHECK_IMPURE || !definition.pure;
+    if(const Obj_p &type = definition.type; !type->is_noobj()) {
       Compiler::coefficient_check(obj->range_coefficient(), type->domain_coefficient());
       //  ObjHelper::check_coefficients(value_obj->range_coefficient(), type->domain_coefficient());
       // if(type->is_type() && !obj->apply(type)->is_noobj())
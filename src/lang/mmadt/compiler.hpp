@@ -23,6 +23,14 @@ FhatOS: A Distributed Operating System
 #include "../../furi.hpp"
 #include "fmt/chrono.h"
 
+#ifndef FOS_INST_CACHE_SIZE
+#define FOS_INST_CACHE_SIZE 512
+#endif
+
+#ifndef FOS_TYPE_CACHE_SIZE
+#define FOS_TYPE_CACHE_SIZE 1024
+#endif
+
 template<typename T>
 class Coefficient;
 using std::make_tuple;
@@ -87,9 +95,31 @@ namespace fhatos {
 
     [[nodiscard]] Inst_p resolve_inst(const Obj_p &lhs, const Inst_p &inst) const;
 
+    /// drop cached inst resolutions affected by a write to the furi (type/inst namespaces and code)
+    static void inst_cache_invalidate(const fURI &furi, const Obj_p &obj);
+
+    static void inst_cache_clear();
+
+    /// changes whenever a resolution could have changed (resolutions held outside the cache check it)
+    [[nodiscard]] static long inst_cache_epoch();
+
+    /// hit/miss/invalidation counters of the inst resolution cache
+    [[nodiscard]] static Obj_p inst_cache_stats();
+
     template<typename COEF = IntCoefficient>
     bool coefficient_check(const COEF &lhs, const COEF &rhs) const;
 
+    /// the definition of a type as read from the router (noobj if undefined) and kept until a write redefines it
+    [[nodiscard]] static Obj_p type_definition(const fURI &type_id);
+
+    /// drop cached type definitions and type checks affected by a write to the furi
+    static void type_cache_invalidate(const fURI &furi, const Obj_p &obj);
+
+    static void type_cache_clear();
+
+    /// hit/miss/invalidation counters of the type check cache
+    [[nodiscard]] static Obj_p type_cache_stats();
+
     bool type_check(const Obj *obj, const ID &type_id) const;
 
     [[nodiscard]] bool type_check(const Obj_p &value_obj, const ID &type_id) const {
@@ -105,6 +135,15 @@ namespace fhatos {
     [[nodiscard]] Obj_p super_type(const Obj_p &value_obj) const;
 
   private:
+    /// the lhs of the outermost (cacheable) resolution and the domains it was type checked against
+    mutable const Obj *cache_lhs_ = nullptr;
+    mutable bool cache_unsafe_ = false;
+    mutable vector<ID_p> cache_guards_;
+
+    [[nodiscard]] Inst_p resolve_inst_obj(const Obj_p &lhs, const Inst_p &inst) const;
+
+    [[nodiscard]] bool type_check_obj(const Obj *obj, const ID &type_id) const;
+
     [[nodiscard]] Inst_p convert_to_inst(const Obj_p &lhs, const Inst_p &stub_inst, const Obj_p &inst_obj) const;
 
     [[nodiscard]] Inst_p merge_inst(const Obj_p &lhs, const Inst_p &inst_provided, const Inst_p &inst_resolved) const;
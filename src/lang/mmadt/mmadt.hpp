@@ -217,6 +217,10 @@ namespace mmadt {
       return this->extend("count");
     }
 
+    [[nodiscard]] _mmADT limit(const Obj_p &rhs) const {
+      return this->extend("limit", rhs);
+    }
+
     [[nodiscard]] _mmADT to(const Obj_p &rhs) const {
       return this->extend("to", rhs);
     }
@@ -142,7 +142,7 @@ namespace mmadt {
               ROUTER_WRITE("/mmadt/inst/blockers",
                            Obj::to_lst({vri("block"), vri("each"), vri("within"), vri("isa"), vri("split"), vri("lift"),
                                         // vri("drop"),
-                                        vri("apply"), vri("choose"), vri("chain")}),
+                                        vri("apply"), vri("choose"), vri("chain"), vri("fuse")}),
                            true);
               Typer::singleton()->start_progress_bar(TOTAL_INSTRUCTIONS);
               InstBuilder::build(MMADT_PREFIX "embed")
@@ -543,27 +543,13 @@ namespace mmadt {
                   ->inst_f([](const Objs_p &lhs, const InstArgs &args) { return args->arg(0)->apply(lhs); })
                   ->save();
 
-              InstBuilder::build(MMADT_PREFIX "sum")
-                  ->domain_range(OBJS_FURI, {0, INT_MAX}, OBJ_FURI, {1, 1})
-                  ->inst_f([](const Obj_p &lhs, const InstArgs &) {
-                    Obj_p sum = nullptr;
-                    for(const auto &obj: *lhs->objs_value()) {
-                      sum = sum ? sum->inst_apply("plus", {obj}) : obj;
-                    }
-                    return sum ? sum : Obj::to_noobj();
-                  })
-                  ->save();
-
-              InstBuilder::build(MMADT_PREFIX "prod")
-                  ->domain_range(OBJS_FURI, {0, INT_MAX}, OBJ_FURI, {1, 1})
-                  ->inst_f([](const Obj_p &lhs, const InstArgs &) {
-                    Obj_p prod = nullptr;
-                    for(const auto &obj: *lhs->objs_value()) {
-                      prod = prod ? prod->inst_apply("mult", std::vector<Obj_p>{obj}) : obj;
-                    }
-                    return prod ? prod : Obj::to_noobj();
-                  })
-                  ->save();
+              // folded by the processor's barriers as monads arrive (see Combiner)
+              for(const auto &op: {"sum", "prod", "min", "max", "mean"}) {
+                InstBuilder::build(MMADT_ID->extend(op))
+                    ->domain_range(OBJS_FURI, {0, INT_MAX}, OBJ_FURI, {1, 1})
+                    ->inst_f([op](const Obj_p &lhs, const InstArgs &) { return Combiner::fold(op, lhs); })
+                    ->save();
+              }
 
               /*InstBuilder::build(MMADT_PREFIX "reduce")
                   ->domain_range(OBJS_FURI, {0,INT_MAX}, OBJ_FURI, {1, 1})
@@ -652,6 +638,26 @@ namespace mmadt {
                   ->inst_f([](const Obj_p &lhs, const InstArgs &args) { return lhs; })
                   ->save();
 
+              // a terminal profile() is run by the processor (see Processor::profile())
+              InstBuilder::build(MMADT_PREFIX "profile")
+                  ->inst_f([](const Obj_p &lhs, const InstArgs &) { return lhs; })
+                  ->save();
+
+              // consecutive pure insts fused by the processor (see Rewriter::fuse())
+              InstBuilder::build(MMADT_PREFIX "fuse")
+                  ->domain_range(OBJ_FURI, {1, 1}, OBJ_FURI, {0, 1})
+                  ->inst_args(lst({Obj::to_bcode()}))
+                  ->inst_f([](const Obj_p &lhs, const InstArgs &args) {
+                    Obj_p obj = lhs;
+                    for(const Inst_p &inst: *args->arg(0)->bcode_value()) {
+                      obj = inst->apply(obj);
+                      if(obj->is_noobj())
+                        break;
+                    }
+                    return obj;
+                  })
+                  ->save();
+
               InstBuilder::build(MMADT_PREFIX "from")
                   ->domain_range(OBJ_FURI, {0, 1}, OBJ_FURI, {0, 1})
                   ->inst_args(lst({__(), __().else_(Obj::to_noobj())}))
@@ -692,6 +698,17 @@ namespace mmadt {
 
                   ->save();
 
+              for(const auto &op: {"limit", "take"}) {
+                // the processor counts the objs a limit lets through (see Processor::admit)
+                InstBuilder::build(MMADT_ID->extend(op))
+                    ->domain_range(OBJ_FURI, {1, 1}, OBJ_FURI, {0, 1})
+                    ->inst_args(lst({Obj::to_bcode()}))
+                    ->inst_f([](const Obj_p &lhs, const InstArgs &args) {
+                      return args->arg(0)->int_value() > 0 ? lhs : Obj::to_noobj();
+                    })
+                    ->save();
+              }
+
               InstBuilder::build(MMADT_PREFIX "map")
                   ->inst_args(lst({Obj::to_bcode()}))
                   ->domain_range(OBJ_FURI, {0, 1}, OBJ_FURI, {0, 1})
@@ -24,6 +24,11 @@ FhatOS: A Distributed Operating System
 #include "../obj.hpp"
 #include "../processor/processor.hpp"
 #include "../util/peglib.h"
+#include "../../util/lru_cache.hpp"
+
+#ifndef FOS_PARSE_CACHE_SIZE
+#define FOS_PARSE_CACHE_SIZE 256
+#endif
 
 #define WRAP(LEFT, DEFINITION, RIGHT) cho(seq(ign(lit((LEFT))), (DEFINITION), ign(lit((RIGHT)))), (DEFINITION))
 #define WRAQ(LEFT, DEF_NOWRAP, DEF_WRAP, RIGHT)                                                                        \
@@ -156,11 +161,35 @@ namespace mmadt {
               ->inst_f([](const Obj_p &, const InstArgs &) {
                 return Obj::to_rec(
                     {{"/mmadt/util/parser",
-                      Obj::to_rec({{"config", __().else_(Obj::to_rec({{"stack_size", jnt(32000)}}))}})}});
+                      Obj::to_rec({{"config", __().else_(Obj::to_rec({{"stack_size", jnt(32000)}}))}})},
+                     {"/mmadt/util/parser::cache", InstBuilder::build("/mmadt/util/parser::cache")
+                                                       ->domain_range(OBJ_FURI, {0, 1}, REC_FURI, {1, 1})
+                                                       ->inst_f([](const Obj_p &, const InstArgs &) {
+                                                         return Parser::cache_stats();
+                                                       })
+                                                       ->create()}});
               })
               ->create());
     }
 
+    /// parsed source (a parse depends only on its source text)
+    static LRUCache<string, Obj_p> *parses() {
+      static LRUCache<string, Obj_p> parses(FOS_PARSE_CACHE_SIZE);
+      return &parses;
+    }
+
+    /// the hit/miss/eviction counters of the parse and plan (see Processor::plan()) caches
+    static Rec_p cache_stats() {
+      const auto stats = [](auto *cache) {
+        return Obj::to_rec({{"size", jnt(static_cast<FOS_INT_TYPE>(cache->size()))},
+                            {"capacity", jnt(static_cast<FOS_INT_TYPE>(cache->capacity()))},
+                            {"hits", jnt(cache->hits.load())},
+                            {"misses", jnt(cache->misses.load())},
+                            {"evictions", jnt(cache->evictions.load())}});
+      };
+      return Obj::to_rec({{"parses", stats(Parser::parses())}, {"plans", stats(Processor::plans())}});
+    }
+
   private:
     Definition WS, START, ARGS, ARGS_LST, ARGS_REC, COMMENT, SINGLE_COMMENT, MULTI_COMMENT, FURI_VAR, FURI, FURI_INLINE,
         FURI_NO_Q, DOM_RNG, START_OBJ, NO_MATCH, NOOBJ, BOOL, INT, REAL, STR, LST, REC, URI, INST, SIGNATURE, OBJS, OBJ,
@@ -210,18 +239,24 @@ namespace mmadt {
     void initialize() {
       OBJ_PARSER = [](const string &obj_string) {
         // StringHelper::replace(const_cast<string *>(&obj_string), "\\\'", "\'");
+        // callers own their parse (the cache holds a copy)
+        if(const std::optional<Obj_p> cached = Parser::parses()->get(obj_string, 0))
+          return Obj_p(cached.value()->clone());
         const Int_p stack_size = Parser::singleton()->obj_get("config/stack_size")->or_else(jnt(KB6));
         const int int_stack_size =
             stack_size->is_code() ? (BOOTING ? KB6 : mmADT::delift(stack_size)->apply(str(obj_string))->int_value())
                                   : (stack_size->is_int() ? stack_size->int_value() : 0);
 
-        return Memory::singleton()->use_custom_stack(InstBuilder::build("custom_parse_stack")
-                                                         ->inst_f([](const Str_p &source, const InstArgs &) {
-                                                           return Parser::singleton()->parse(
-                                                               source->str_value().c_str());
-                                                         })
-                                                         ->create(),
-                                                     Obj::to_str(obj_string), int_stack_size);
+        const Obj_p parse = Memory::singleton()->use_custom_stack(
+            InstBuilder::build("custom_parse_stack")
+                ->inst_f([](const Str_p &source, const InstArgs &) {
+                  return Parser::singleton()->parse(source->str_value().c_str());
+                })
+                ->create(),
+            Obj::to_str(obj_string), int_stack_size);
+        if(Processor::cacheable(parse))
+          Parser::parses()->put(obj_string, parse->clone(), 0);
+        return parse;
       };
       auto noobj_action = [](const SemanticValues &) -> Pair<Any, OType> { return {nullptr, OType::NOOBJ}; };
       auto bool_action = [](const SemanticValues &vs) -> Pair<Any, OType> { return {vs.choice() == 0, OType::BOOL}; };
@@ -466,7 +501,7 @@ namespace mmadt {
 
       auto start_obj_action = [start_action](const SemanticValues &vs) -> Pair<Any, OType> {
         const auto obj = start_action(vs);
-        return {obj->value_, obj->otype};
+        return {obj->value_.to_any(), obj->otype};
       };
 
       auto is_maker = [](const ID_p &predicate, const Obj_p &obj) -> Inst_p {
@@ -23,34 +23,149 @@
 #include "../../fhatos.hpp"
 #include "../obj.hpp"
 #include "../../util/string_printer.hpp"
+#include "../../model/fos/sys/scheduler/thread/mutex.hpp"
+#include "compiler.hpp"
 #include "mmadt_obj.hpp"
+#include <unordered_set>
+
+#define REWRITE_BY MMADT_SCHEME "/rewrite/by"
+#define REWRITE_EXPLAIN "/lang/rewrite/explain"
+#define REWRITE_COLLAPSE MMADT_SCHEME "/rewrite/collapse"
+#define REWRITE_FOLD MMADT_SCHEME "/rewrite/fold"
+#define REWRITE_PUSHDOWN MMADT_SCHEME "/rewrite/pushdown"
+#define REWRITE_DEAD MMADT_SCHEME "/rewrite/dead"
+#define REWRITE_FUSE MMADT_SCHEME "/rewrite/fuse"
 
 namespace fhatos {
+  /// the rewrites that must run before and after a rewrite
   using PriorPost = Pair<List<ID>, List<ID>>;
   using Rewrite = Trip<ID, Function<BCode_p, BCode_p>, PriorPost>;
 
+  /// a rewrite's toggle and counters (shared by every rewriter)
+  struct RewriteStats {
+    atomic<bool> enabled{true};
+    /// the bcodes the rewrite was applied to
+    atomic<long> applied{0};
+    /// the bcodes the rewrite changed
+    atomic<long> rewrote{0};
+  };
+
   struct Rewriter {
     List<Rewrite> _rewrites;
+    List<RewriteStats *> _stats;
 
-    explicit Rewriter(const List<Rewrite> &rewrites) : _rewrites(rewrites) {
+    explicit Rewriter(const List<Rewrite> &rewrites) : _rewrites(Rewriter::order(rewrites)) {
+      for(const Rewrite &rw: this->_rewrites) {
+        this->_stats.push_back(Rewriter::stats(std::get<0>(rw)));
+      }
     }
 
     BCode_p apply(const BCode_p &bcode) const {
       BCode_p running = bcode;
-      for(const Rewrite &rw: this->_rewrites) {
+      for(size_t i = 0; i < this->_rewrites.size(); i++) {
+        RewriteStats *stats = this->_stats.at(i);
+        if(!stats->enabled.load(std::memory_order_relaxed))
+          continue;
+        const Rewrite &rw = this->_rewrites.at(i);
         LOG(TRACE, "applying !yrewrite !b%s!!\n", std::get<0>(rw).toString().c_str());
-        running = std::get<1>(rw)(running);
+        const BCode_p rewrite = std::get<1>(rw)(running);
+        ++stats->applied;
+        if(rewrite != running)
+          ++stats->rewrote;
+        running = rewrite;
       }
       return running;
     }
 
+    /// the rewrites in an order where each runs after its priors and before its posts (otherwise as given)
+    static List<Rewrite> order(const List<Rewrite> &rewrites) {
+      const auto contains = [](const List<ID> &ids, const ID &id) {
+        return std::any_of(ids.begin(), ids.end(), [&id](const ID &i) { return i.equals(id); });
+      };
+      const auto before = [&rewrites, &contains](const size_t a, const size_t b) {
+        return contains(std::get<2>(rewrites.at(b)).first, std::get<0>(rewrites.at(a))) ||
+               contains(std::get<2>(rewrites.at(a)).second, std::get<0>(rewrites.at(b)));
+      };
+      List<Rewrite> ordered;
+      List<bool> placed(rewrites.size(), false);
+      while(ordered.size() < rewrites.size()) {
+        bool progress = false;
+        for(size_t i = 0; i < rewrites.size() && !progress; i++) {
+          if(placed.at(i))
+            continue;
+          bool ready = true;
+          for(size_t j = 0; j < rewrites.size() && ready; j++) {
+            if(j != i && !placed.at(j) && before(j, i))
+              ready = false;
+          }
+          if(ready) {
+            ordered.push_back(rewrites.at(i));
+            placed.at(i) = true;
+            progress = true;
+          }
+        }
+        if(!progress)
+          throw fError("!yrewrites!! have a !rcyclic!! prior/post ordering");
+      }
+      return ordered;
+    }
+
+    static RewriteStats *stats(const ID &rewrite_id) {
+      static Mutex mutex;
+      static Map<string, uptr<RewriteStats>> stats;
+      auto lock = std::lock_guard<Mutex>(mutex);
+      uptr<RewriteStats> &s = stats[rewrite_id.toString()];
+      if(!s)
+        s = make_unique<RewriteStats>();
+      return s.get();
+    }
+
+    static void enable(const ID &rewrite_id, const bool enabled) {
+      Rewriter::stats(rewrite_id)->enabled = enabled;
+      ++Rewriter::version();
+    }
+
+    /// bumped by every toggle (rewritten bcodes held outside a rewriter check it)
+    static atomic<long> &version() {
+      static atomic<long> version{0};
+      return version;
+    }
+
+    static bool enabled(const ID &rewrite_id) { return Rewriter::stats(rewrite_id)->enabled.load(); }
+
+    static List<ID> rewrite_ids() {
+      return {REWRITE_BY, REWRITE_COLLAPSE, REWRITE_FOLD, REWRITE_PUSHDOWN, REWRITE_DEAD, REWRITE_FUSE, REWRITE_EXPLAIN};
+    }
+
+    /// each rewrite's toggle and counters
+    static Rec_p stats_rec() {
+      const Rec_p rec = Obj::to_rec();
+      for(const ID &id: Rewriter::rewrite_ids()) {
+        const RewriteStats *s = Rewriter::stats(id);
+        rec->insert_into_position(vri(id), Obj::to_rec({{"enabled", dool(s->enabled.load())},
+                                                        {"applied", jnt(s->applied.load())},
+                                                        {"rewrote", jnt(s->rewrote.load())}}));
+      }
+      return rec;
+    }
+
+    /// the optimization passes run by the processor
+    static List<Rewrite> optimizations(const bool fuse = true) {
+      List<Rewrite> rewrites = {Rewriter::collapse(), Rewriter::fold(), Rewriter::dead()};
+      if(fuse) {
+        rewrites.push_back(Rewriter::pushdown());
+        rewrites.push_back(Rewriter::fuse());
+      }
+      return rewrites;
+    }
+
     static void LOG_REWRITE(const ID &rewriteID, const BCode_p &original, const BCode_p &rewrite) {
       LOG(DEBUG, "!g[!b%s!g]!! !yrewrote!! %s !r=to=>!! %s\n", rewriteID.toString().c_str(),
           original->toString().c_str(), rewrite->toString().c_str());
     }
 
     static Rewrite explain() {
-      return Rewrite(ID("/lang/rewrite/explain"),
+      return Rewrite(ID(REWRITE_EXPLAIN),
         [](const BCode_p &bcode) {
           if(bcode->bcode_value()->back()->inst_op() == "explain") {
             auto ex = string();
@@ -82,11 +197,12 @@ namespace fhatos {
           }
           return bcode;
         },
-        {{}, {}});
+        // the explained plan is the optimized plan
+        {{REWRITE_BY, REWRITE_COLLAPSE, REWRITE_FOLD, REWRITE_PUSHDOWN, REWRITE_DEAD, REWRITE_FUSE}, {}});
     }
 
     static Rewrite by() {
-      return Rewrite({MMADT_SCHEME "/rewrite/by",
+      return Rewrite({REWRITE_BY,
         [](const BCode_p &bcode) {
           Inst_p prev = Obj::to_noobj();
           bool found = false;
@@ -116,6 +232,345 @@ namespace fhatos {
     }
 
 
+    ///////////////////////////////////////////////////////////////////////////
+    ///////////////////////////// OPTIMIZATIONS ///////////////////////////////
+    ///////////////////////////////////////////////////////////////////////////
+
+    /// builtin insts that are functions of their lhs and args (no side effects or reads)
+    static bool pure(const string &op) {
+      static const std::unordered_set<string> PURE = {"plus", "minus", "mult", "div", "mod", "gt",
+                                                      "gte",  "lt",    "lte",  "eq",  "neq", "is"};
+      return PURE.count(op) > 0;
+    }
+
+    /// a value that is its own evaluation (a bool, int, real, or str without code blocks)
+    static bool constant(const Obj_p &obj) {
+      if(obj->vid)
+        return false;
+      switch(obj->otype) {
+        case OType::BOOL:
+        case OType::INT:
+        case OType::REAL:
+          return true;
+        case OType::STR:
+          return string::npos == obj->str_value().find("{{");
+        default:
+          return false;
+      }
+    }
+
+    static bool base_int(const Obj_p &obj) { return obj->is_int() && !obj->vid && obj->tid->equals(*INT_FURI); }
+
+    /// a pure inst whose args are constants or pure code (its output only depends on its lhs)
+    static bool pure_inst(const Obj_p &inst) {
+      if(!inst->is_inst() || inst->vid || !Rewriter::pure(inst->inst_op()))
+        return false;
+      for(const auto &[key, arg]: *inst->inst_args()->rec_value()) {
+        if(Rewriter::constant(arg) || (arg->is_inst() && Rewriter::pure_inst(arg)))
+          continue;
+        if(!arg->is_bcode() || !std::all_of(arg->bcode_value()->begin(), arg->bcode_value()->end(),
+                                            [](const Inst_p &i) { return Rewriter::pure_inst(i); }))
+          return false;
+      }
+      return true;
+    }
+
+    /// integer division by zero is left for the processor to raise
+    static bool int_zero_division(const Inst_p &resolved) {
+      const string op = resolved->inst_op();
+      if(("div" != op && "mod" != op) || resolved->inst_args()->rec_value()->empty())
+        return false;
+      const Obj_p rhs = resolved->inst_args()->arg(0);
+      return rhs->is_int() && 0 == rhs->int_value();
+    }
+
+    /// the single inst of an inst arg (or nullptr)
+    static Inst_p single_inst(const Obj_p &arg) {
+      if(arg->is_inst())
+        return arg;
+      if(arg->is_bcode() && 1 == arg->bcode_value()->size())
+        return arg->bcode_value()->front();
+      return nullptr;
+    }
+
+    /// whether a constant is() arg of the given truth
+    static bool is_constant(const Inst_p &inst, const bool truth) {
+      if("is" != inst->inst_op())
+        return false;
+      const Obj_p arg = inst->inst_args()->arg(0);
+      return arg->is_bool() && !arg->vid && truth == arg->bool_value();
+    }
+
+    /// no obj gets past the inst (is(false), map(noobj), block(noobj), or a start of nothing)
+    static bool nothing(const Inst_p &inst) {
+      const string op = inst->inst_op();
+      if(Rewriter::is_constant(inst, false))
+        return true;
+      if(inst->inst_args()->rec_value()->empty())
+        return false;
+      const Obj_p arg = inst->inst_args()->arg(0);
+      if("map" == op || "block" == op)
+        return arg->is_noobj();
+      if("start" == op)
+        return arg->is_noobj() || (arg->is_objs() && arg->objs_value()->empty());
+      return false;
+    }
+
+    /// a gather inst (resolved as the processor resolves its barriers)
+    static bool barrier(const Inst_p &inst) {
+      if("explain" == inst->inst_op())
+        return true;
+      try {
+        return TYPE_INST_RESOLVER(Obj::to_type(OBJ_FURI), inst)->is_gather();
+      } catch(const fError &) {
+        return false;
+      }
+    }
+
+    /// block and lift ignore their lhs and (unless a block of noobj or objs) emit one obj
+    static bool lhs_ignored(const Inst_p &inst) {
+      const string op = inst->inst_op();
+      if("lift" == op)
+        return true;
+      if("block" != op || inst->inst_args()->rec_value()->empty())
+        return false;
+      const Obj_p arg = inst->inst_args()->arg(0);
+      return !arg->is_noobj() && !arg->is_objs();
+    }
+
+    /// block/lift chains: a block or lift directly followed by a block or lift has no effect
+    static Rewrite collapse() {
+      return Rewrite(ID(REWRITE_COLLAPSE),
+                     [](const BCode_p &bcode) {
+                       const InstList_p insts = bcode->bcode_value();
+                       List<Inst_p> rewrite;
+                       for(size_t i = 0; i < insts->size(); i++) {
+                         const string next = i + 1 < insts->size() ? insts->at(i + 1)->inst_op() : "";
+                         if(!Rewriter::lhs_ignored(insts->at(i)) || ("block" != next && "lift" != next))
+                           rewrite.push_back(insts->at(i));
+                       }
+                       if(rewrite.size() == insts->size())
+                         return bcode;
+                       const BCode_p collapsed = Obj::to_bcode(rewrite);
+                       LOG_REWRITE(REWRITE_COLLAPSE, bcode, collapsed);
+                       return collapsed;
+                     },
+                     {{REWRITE_BY}, {}});
+    }
+
+    /// constant folding: the constants of a start are run through the pure insts that follow it
+    /// (an inst that errors or resolves to a user type's inst is left for the processor)
+    static Rewrite fold() {
+      return Rewrite(
+          ID(REWRITE_FOLD),
+          [](const BCode_p &bcode) {
+            const InstList_p insts = bcode->bcode_value();
+            if(insts->size() < 2 || "start" != insts->front()->inst_op() ||
+               insts->front()->inst_args()->rec_value()->empty())
+              return bcode;
+            const Obj_p seed = insts->front()->inst_args()->arg(0);
+            List<Obj_p> objs = seed->is_objs() ? *seed->objs_value() : List<Obj_p>{seed};
+            if(!std::all_of(objs.begin(), objs.end(), [](const Obj_p &o) { return Rewriter::constant(o); }))
+              return bcode;
+            const Compiler compiler;
+            size_t i = 1;
+            for(; i < insts->size() && Rewriter::pure_inst(insts->at(i)); i++) {
+              List<Obj_p> folded;
+              bool folding = true;
+              try {
+                for(const Obj_p &obj: objs) {
+                  const Inst_p resolved = compiler.resolve_inst(obj, insts->at(i));
+                  if(!resolved->tid->starts_with(MMADT_SCHEME "/") || Rewriter::int_zero_division(resolved)) {
+                    folding = false;
+                    break;
+                  }
+                  const Obj_p result = resolved->apply(obj);
+                  if(result->is_noobj())
+                    continue;
+                  if(!Rewriter::constant(result)) {
+                    folding = false;
+                    break;
+                  }
+                  folded.push_back(result);
+                }
+              } catch(...) {
+                // the processor raises the error
+                folding = false;
+              }
+              if(!folding)
+                break;
+              objs = std::move(folded);
+            }
+            if(1 == i)
+              return bcode;
+            List<Inst_p> rewrite = {
+                Obj::to_inst({Obj::to_objs(make_shared<List<Obj_p>>(objs))}, insts->front()->tid)};
+            rewrite.insert(rewrite.end(), insts->begin() + i, insts->end());
+            const BCode_p folded = Obj::to_bcode(rewrite);
+            LOG_REWRITE(REWRITE_FOLD, bcode, folded);
+            return folded;
+          },
+          {{REWRITE_BY, REWRITE_COLLAPSE}, {}});
+    }
+
+    /// whether an inst's output is known to be a base int (given whether its lhs is)
+    static bool int_range(const Inst_p &inst, const bool int_lhs) {
+      const string op = inst->inst_op();
+      if("start" == op) {
+        if(inst->inst_args()->rec_value()->empty())
+          return false;
+        const Obj_p seed = inst->inst_args()->arg(0);
+        return seed->is_objs() ? std::all_of(seed->objs_value()->begin(), seed->objs_value()->end(),
+                                             [](const Obj_p &o) { return Rewriter::base_int(o); })
+                               : Rewriter::base_int(seed);
+      }
+      if("is" == op || "limit" == op)
+        return int_lhs;
+      if(int_lhs && ("plus" == op || "minus" == op || "mult" == op || "mod" == op) &&
+         !inst->inst_args()->rec_value()->empty())
+        return Rewriter::base_int(inst->inst_args()->arg(0));
+      return false;
+    }
+
+    /// is(cmp(c)) after an int plus/minus/mult(k) as an equivalent is() before it (or nullptr)
+    static Inst_p shift(const Inst_p &map, const Inst_p &filter) {
+      const string op = map->inst_op();
+      if(("plus" != op && "minus" != op && "mult" != op) || map->inst_args()->rec_value()->empty())
+        return nullptr;
+      const Obj_p k = map->inst_args()->arg(0);
+      const Inst_p predicate = Rewriter::single_inst(filter->inst_args()->arg(0));
+      if(!Rewriter::base_int(k) || !predicate || predicate->inst_args()->rec_value()->empty() ||
+         !Rewriter::base_int(predicate->inst_args()->arg(0)))
+        return nullptr;
+      const string cmp = predicate->inst_op();
+      const FOS_INT_TYPE c = predicate->inst_args()->arg(0)->int_value();
+      FOS_INT_TYPE shifted;
+      if("plus" == op || "minus" == op) {
+        if(cmp != "gt" && cmp != "gte" && cmp != "lt" && cmp != "lte" && cmp != "eq" && cmp != "neq")
+          return nullptr;
+        if("plus" == op ? __builtin_sub_overflow(c, k->int_value(), &shifted)
+                        : __builtin_add_overflow(c, k->int_value(), &shifted))
+          return nullptr;
+      } else {
+        // x*k > c <=> x > floor(c/k) and x*k >= c <=> x >= ceil(c/k) (k > 0)
+        const FOS_INT_TYPE d = k->int_value();
+        if(d <= 0)
+          return nullptr;
+        const FOS_INT_TYPE floor = c / d - (c % d != 0 && c < 0 ? 1 : 0);
+        const FOS_INT_TYPE ceil = c / d + (c % d != 0 && c > 0 ? 1 : 0);
+        if("gt" == cmp || "lte" == cmp)
+          shifted = floor;
+        else if("gte" == cmp || "lt" == cmp)
+          shifted = ceil;
+        else
+          return nullptr;
+      }
+      const Inst_p moved = Obj::to_inst({jnt(shifted)}, predicate->tid);
+      return Obj::to_inst({filter->inst_args()->arg(0)->is_inst() ? moved : Obj::to_bcode({moved})}, filter->tid);
+    }
+
+    /// filter pushdown: an is() moves ahead of the pure maps it commutes with
+    ///   a constant is(bool) commutes with every pure map
+    ///   on ints, is(cmp(c)) after plus/minus(k) (or mult(k>0) for gt/gte/lt/lte) is rewritten to go before it
+    /// the filtered objs are dead monads at the map so the filter and map must be fused (see fuse())
+    static Rewrite pushdown() {
+      return Rewrite(ID(REWRITE_PUSHDOWN),
+                     [](const BCode_p &bcode) {
+                       if(!Rewriter::enabled(REWRITE_FUSE))
+                         return bcode;
+                       List<Inst_p> insts = *bcode->bcode_value();
+                       bool changed = false;
+                       for(bool moved = true; moved;) {
+                         moved = false;
+                         bool int_lhs = false;
+                         for(size_t i = 1; i < insts.size() && !moved; i++) {
+                           const bool map_int_lhs = int_lhs;
+                           int_lhs = Rewriter::int_range(insts.at(i - 1), int_lhs);
+                           const Inst_p map = insts.at(i - 1);
+                           const Inst_p filter = insts.at(i);
+                           if(1 == i || "is" != filter->inst_op() || "is" == map->inst_op() ||
+                              !Rewriter::pure_inst(map))
+                             continue;
+                           if(filter->inst_args()->arg(0)->is_bool()) {
+                             insts.at(i - 1) = filter;
+                             insts.at(i) = map;
+                             moved = true;
+                           } else if(map_int_lhs) {
+                             if(const Inst_p shifted = Rewriter::shift(map, filter)) {
+                               insts.at(i - 1) = shifted;
+                               insts.at(i) = map;
+                               moved = true;
+                             }
+                           }
+                         }
+                         changed = changed || moved;
+                       }
+                       if(!changed)
+                         return bcode;
+                       const BCode_p pushed = Obj::to_bcode(insts);
+                       LOG_REWRITE(REWRITE_PUSHDOWN, bcode, pushed);
+                       return pushed;
+                     },
+                     {{REWRITE_FOLD}, {}});
+    }
+
+    /// dead-inst elimination: the insts after a noobj producing inst are dropped up to the next gather
+    /// (a gather of nothing still has a result) as is every is(true)
+    static Rewrite dead() {
+      return Rewrite(ID(REWRITE_DEAD),
+                     [](const BCode_p &bcode) {
+                       const InstList_p insts = bcode->bcode_value();
+                       List<Inst_p> rewrite;
+                       bool dead = false;
+                       for(const Inst_p &inst: *insts) {
+                         if(dead && !Rewriter::barrier(inst))
+                           continue;
+                         if(!rewrite.empty() && Rewriter::is_constant(inst, true))
+                           continue;
+                         rewrite.push_back(inst);
+                         dead = Rewriter::nothing(inst);
+                       }
+                       if(rewrite.size() == insts->size())
+                         return bcode;
+                       const BCode_p live = Obj::to_bcode(rewrite);
+                       LOG_REWRITE(REWRITE_DEAD, bcode, live);
+                       return live;
+                     },
+                     {{REWRITE_FOLD, REWRITE_PUSHDOWN}, {}});
+    }
+
+    /// map fusion: consecutive pure insts become one fuse inst (a single monad step rather than one per inst)
+    static Rewrite fuse() {
+      return Rewrite(ID(REWRITE_FUSE),
+                     [](const BCode_p &bcode) {
+                       const InstList_p insts = bcode->bcode_value();
+                       List<Inst_p> rewrite;
+                       List<Inst_p> run;
+                       const auto flush = [&rewrite, &run]() {
+                         if(run.size() > 1)
+                           rewrite.push_back(Obj::to_inst({Obj::to_bcode(run)}, id_p("fuse")));
+                         else
+                           rewrite.insert(rewrite.end(), run.begin(), run.end());
+                         run.clear();
+                       };
+                       for(size_t i = 0; i < insts->size(); i++) {
+                         if(i > 0 && Rewriter::pure_inst(insts->at(i)))
+                           run.push_back(insts->at(i));
+                         else {
+                           flush();
+                           rewrite.push_back(insts->at(i));
+                         }
+                       }
+                       flush();
+                       if(rewrite.size() == insts->size())
+                         return bcode;
+                       const BCode_p fused = Obj::to_bcode(rewrite);
+                       LOG_REWRITE(REWRITE_FUSE, bcode, fused);
+                       return fused;
+                     },
+                     {{REWRITE_FOLD, REWRITE_PUSHDOWN, REWRITE_DEAD}, {}});
+    }
+
     static Rewrite starts(const Objs_p &starts) {
       return Rewrite(MMADT_SCHEME "/rewrite/starts",
                      [starts](const BCode_p &bcode) {
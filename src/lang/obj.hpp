@@ -356,6 +356,8 @@ namespace fhatos {
     LOG(ERROR, "!yTYPE_SAVER!! undefined at this point in bootstrap: %s\n", type_id.toString().c_str());
     ROUTER_WRITE(type_id, obj, true);
   };
+  /// set by a caller that has proven the domain check of the inst it applies next (consumed by that apply)
+  inline thread_local bool DOMAIN_CHECKED = false;
   inline BiFunction<const Obj_p &, const Inst_p &, Inst_p> TYPE_INST_RESOLVER = [](const Obj_p &, const Inst_p &) {
     LOG(ERROR, "!RESOLVE_INST!! undefined at this point in bootstrap\n");
     return nullptr;
@@ -373,6 +375,117 @@ namespace fhatos {
 
   class ObjsSet;
 
+  //////////////////////////////////////////////////
+  //////////////////// OBJ VALUE //////////////////
+  /////////////////////////////////////////////////
+  /// The value of an obj as a tagged union: noobj/bool/int/real are stored inline (no std::any indirection)
+  /// and all other values (str, uri, polys, insts, ...) are boxed in an Any
+  class ObjValue {
+  public:
+    enum class Tag : uint8_t { EMPTY, NIL, BOOL, INT, REAL, BOXED };
+
+  protected:
+    Tag tag_ = Tag::EMPTY;
+    union {
+      bool bool_;
+      FOS_INT_TYPE int_;
+      FOS_REAL_TYPE real_;
+    };
+    Any boxed_;
+
+    void unbox(const Any &any) {
+      if(!any.has_value())
+        this->tag_ = Tag::EMPTY;
+      else if(std::any_cast<std::nullptr_t>(&any))
+        this->tag_ = Tag::NIL;
+      else if(const auto *b = std::any_cast<bool>(&any)) {
+        this->tag_ = Tag::BOOL;
+        this->bool_ = *b;
+      } else if(const auto *i = std::any_cast<FOS_INT_TYPE>(&any)) {
+        this->tag_ = Tag::INT;
+        this->int_ = *i;
+      } else if(const auto *r = std::any_cast<FOS_REAL_TYPE>(&any)) {
+        this->tag_ = Tag::REAL;
+        this->real_ = *r;
+      } else {
+        this->tag_ = Tag::BOXED;
+        this->boxed_ = any;
+      }
+    }
+
+  public:
+    ObjValue() : int_(0) {}
+
+    template<typename T, typename = std::enable_if_t<!std::is_same_v<std::decay_t<T>, ObjValue>>>
+    ObjValue(T &&value) : int_(0) { // NOLINT(*-explicit-constructor)
+      using V = std::decay_t<T>;
+      if constexpr(std::is_same_v<V, Any>)
+        this->unbox(value);
+      else if constexpr(std::is_same_v<V, std::nullptr_t>)
+        this->tag_ = Tag::NIL;
+      else if constexpr(std::is_same_v<V, bool>) {
+        this->tag_ = Tag::BOOL;
+        this->bool_ = value;
+      } else if constexpr(std::is_same_v<V, FOS_INT_TYPE>) {
+        this->tag_ = Tag::INT;
+        this->int_ = value;
+      } else if constexpr(std::is_same_v<V, FOS_REAL_TYPE>) {
+        this->tag_ = Tag::REAL;
+        this->real_ = value;
+      } else {
+        this->tag_ = Tag::BOXED;
+        this->boxed_ = Any(std::forward<T>(value));
+      }
+    }
+
+    ObjValue(const ObjValue &) = default;
+    ObjValue(ObjValue &&) noexcept = default;
+    ObjValue &operator=(const ObjValue &) = default;
+    ObjValue &operator=(ObjValue &&) noexcept = default;
+
+    [[nodiscard]] Tag tag() const { return this->tag_; }
+
+    [[nodiscard]] bool has_value() const { return Tag::EMPTY != this->tag_; }
+
+    template<typename T>
+    [[nodiscard]] const T *get_if() const {
+      using V = std::remove_cv_t<T>;
+      if constexpr(std::is_same_v<V, bool>)
+        return Tag::BOOL == this->tag_ ? &this->bool_ : nullptr;
+      else if constexpr(std::is_same_v<V, FOS_INT_TYPE>)
+        return Tag::INT == this->tag_ ? &this->int_ : nullptr;
+      else if constexpr(std::is_same_v<V, FOS_REAL_TYPE>)
+        return Tag::REAL == this->tag_ ? &this->real_ : nullptr;
+      else
+        return Tag::BOXED == this->tag_ ? std::any_cast<V>(&this->boxed_) : nullptr;
+    }
+
+    /// @throws std::bad_any_cast if the value is not a T (as std::any_cast would)
+    template<typename T>
+    [[nodiscard]] T get() const {
+      if(const auto *t = this->get_if<std::remove_cv_t<std::remove_reference_t<T>>>())
+        return *t;
+      throw std::bad_any_cast();
+    }
+
+    [[nodiscard]] Any to_any() const {
+      switch(this->tag_) {
+        case Tag::NIL:
+          return Any(nullptr);
+        case Tag::BOOL:
+          return Any(this->bool_);
+        case Tag::INT:
+          return Any(this->int_);
+        case Tag::REAL:
+          return Any(this->real_);
+        case Tag::BOXED:
+          return this->boxed_;
+        default:
+          return {};
+      }
+    }
+  };
+
   //////////////////////////////////////////////////
   ////////////////////// OBJ //////////////////////
   /////////////////////////////////////////////////
@@ -386,7 +499,13 @@ namespace fhatos {
               public enable_shared_from_this<const Obj> {
   public:
     OType otype;
-    Any value_;
+    ObjValue value_;
+
+  protected:
+    // 0 = not yet computed (only mono values are cached as polys are mutated in place)
+    mutable std::atomic<size_t> hash_{0};
+
+  public:
 
     template<typename T>
     [[nodiscard]] ptr<const T> get_shared_from_this() const {
@@ -394,11 +513,18 @@ namespace fhatos {
     }
 
     struct objp_hash {
-      size_t operator()(const Obj_p &obj) const { return std::hash<std::string>{}(obj->toString()); }
+      size_t operator()(const Obj_p &obj) const { return obj->hash(); }
     };
 
     struct objp_equal_to {
-      bool operator()(const Obj_p &a, const Obj_p &b) const { return a->equals(*b); }
+      bool operator()(const Obj_p &a, const Obj_p &b) const {
+        if(a == b)
+          return true;
+        // cached mono hashes are a cheap way to reject before a full (resolving) equals
+        if(a->is_hash_cached() && b->is_hash_cached() && a->hash() != b->hash())
+          return false;
+        return a->equals(*b);
+      }
     };
 
     struct obj_comp : std::less<> {
@@ -411,7 +537,9 @@ namespace fhatos {
     struct objp_comp : std::less<> {
       template<class K1 = Obj_p, class K2 = Obj_p>
       auto operator()(K1 &k1, K2 &k2) const {
-        return k1->toString() > k2->toString();
+        const size_t h1 = k1->hash();
+        const size_t h2 = k2->hash();
+        return h1 != h2 ? h1 > h2 : k1->toString() > k2->toString();
       }
     };
 
@@ -426,8 +554,10 @@ namespace fhatos {
     ///////////////////////////////////////////////////////////////////
     ///////////////////////////////////////////////////////////////////
 
-    explicit Obj(const Any &value, const OType otype, const ID_p &type_id, const ID_p &value_id = nullptr) :
-        Typed(type_id), Valued(value_id), otype(otype), value_(value) {}
+    explicit Obj(const ObjValue &value, const OType otype, const ID_p &type_id, const ID_p &value_id = nullptr) :
+        Typed(type_id), Valued(value_id), otype(otype), value_(value) {
+      ++PROFILE_COUNTERS.allocations;
+    }
 
     Obj(Obj &&other) noexcept : Obj(std::move(other.value_), other.otype, std::move(other.tid), std::move(other.vid)) {
       other.value_ = nullptr;
@@ -441,7 +571,9 @@ namespace fhatos {
       this->otype = other.otype;
       this->vid = std::move(other.vid);
       this->tid = std::move(other.tid);
+      this->hash_.store(0);
       other.value_ = nullptr;
+      other.hash_.store(0);
       return *this;
     }
 
@@ -498,7 +630,7 @@ namespace fhatos {
       }
     }
 
-    static Obj_p create(const Any &value, const OType otype, const ID_p &type_id, const ID_p &value_id = nullptr) {
+    static Obj_p create(const ObjValue &value, const OType otype, const ID_p &type_id, const ID_p &value_id = nullptr) {
       const auto creation = make_shared<Obj>(value, otype, type_id, value_id);
       creation->type_check();
       if(creation->vid)
@@ -509,9 +641,9 @@ namespace fhatos {
     void type_check() {
       if(this->is_base_type())
         return;
-      if(this->otype == OType::INST && nullptr == std::get<2>(std::any_cast<InstValue>(this->value_))) {
-        this->value_ = make_tuple(std::get<0>(std::any_cast<InstValue>(this->value_)),
-                                  std::get<1>(std::any_cast<InstValue>(this->value_)),
+      if(this->otype == OType::INST && nullptr == std::get<2>(this->value_.get<InstValue>())) {
+        this->value_ = make_tuple(std::get<0>(this->value_.get<InstValue>()),
+                                  std::get<1>(this->value_.get<InstValue>()),
                                   this->is_gather() ? Obj::to_objs() : Obj::to_noobj());
       }
       if(this->otype == OType::INST && this->tid->has_query(FOS_RANGE) &&
@@ -524,7 +656,7 @@ namespace fhatos {
             if(/*(otype == OType::REC || otype == OType::LST) && !this->tid->equals(*OTYPE_FURI.at(otype)) &&*/
                !this->tid->matches("/sys/#") && // TODO: REMOVE WHEN ALL TYPES HAVE BEEN WRITTEN USING QUERY TYPES
                !this->tid->matches("/io/#")) {
-              if(const Obj_p type_obj = ROUTER_READ(*this->tid);
+              if(const Obj_p type_obj = Compiler::type_definition(*this->tid);
                  !type_obj->is_noobj() && type_obj->otype == this->otype) {
                 Obj_p plain_type_obj;
                 if(type_obj->otype == OType::REC) {
@@ -544,8 +676,10 @@ namespace fhatos {
                          k1->uri_value().no_query().equals(k2->uri_value().no_query())) {
                         if(k1->uri_value().has_query() && !k2->uri_value().has_query()) {
                           const_cast<Obj *>(k2.get())->value_ = k1->uri_value();
+                          k2->hash_.store(0);
                         } else if(!k1->uri_value().has_query() && k2->uri_value().has_query()) {
                           const_cast<Obj *>(k1.get())->value_ = k2->uri_value();
+                          k1->hash_.store(0);
                         }
                       }
                     }
@@ -560,6 +694,7 @@ namespace fhatos {
                 }
                 this->value_ = applied_obj->value_;
                 this->otype = applied_obj->otype;
+                this->hash_.store(0);
               }
             }
           }
@@ -596,20 +731,21 @@ namespace fhatos {
       if(this->vid) {
         if(this->is_rec() && !subset.equals("#") && !subset.empty()) {
           const fURI subset_furi = this->vid->extend(subset);
-          const Obj_p fresh = ROUTER_READ(subset_furi);
+          const Obj_p fresh = ROUTER_READ(subset_furi)->clone(); // reads may be shared (copy-on-write)
           const Uri_p subset_uri = Obj::to_uri(subset_furi);
           if(fresh->is_noobj())
             this->rec_drop(subset_uri);
           else
             this->rec_set(subset_uri, fresh);
         } else {
-          const Obj_p fresh = ROUTER_READ(*this->vid);
+          const Obj_p fresh = ROUTER_READ(*this->vid)->clone();
           if(this->otype != fresh->otype) {
             throw fError("%s synchronization yielded different base types: %s != %s", this->vid->toString().c_str(),
                          OTypes.to_chars(this->otype).c_str(), OTypes.to_chars(fresh->otype).c_str());
           }
           const_cast<Obj *>(this)->value_ = fresh->value_;
           const_cast<Obj *>(this)->tid = fresh->tid;
+          this->hash_.store(0);
         }
       }
     }
@@ -644,7 +780,7 @@ namespace fhatos {
     template<typename VALUE>
     [[nodiscard]] VALUE value() const {
       try {
-        return std::any_cast<VALUE>(this->value_);
+        return this->value_.get<VALUE>();
       } catch(const std::bad_any_cast &) {
         throw TYPE_ERROR(this, __FUNCTION__, __LINE__);
       }
@@ -688,6 +824,11 @@ namespace fhatos {
       return value_furi;
     }
 
+    /// the uri value without a copy (nullptr if not a uri)
+    [[nodiscard]] const fURI *uri_value_ptr() const {
+      return this->is_uri() ? this->value_.get_if<fURI>() : nullptr;
+    }
+
     [[nodiscard]] string str_value() const {
       if(!this->is_str())
         throw TYPE_ERROR(this, __FUNCTION__, __LINE__);
@@ -990,7 +1131,7 @@ namespace fhatos {
         const Obj_p v = this->poly_get(Obj::to_uri(key));
         if(v->is_noobj())
           throw fError("!b%s!! has no value for !b%s!!", key.toString().c_str());
-        return std::any_cast<T>(v->value_);
+        return v->value_.get<T>();
       } catch(const std::bad_any_cast &e) {
         throw fError::create("wrong underlying type of %s in %s: %s", key.toString().c_str(), this->toString().c_str(),
                              e.what());
@@ -1451,7 +1592,84 @@ namespace fhatos {
       }
     }
 
-    [[nodiscard]] size_t hash() const { return std::hash<std::string>{}(this->toString()); }
+    [[nodiscard]] bool is_hash_cached() const {
+      switch(this->otype) {
+        case OType::NOOBJ:
+        case OType::BOOL:
+        case OType::INT:
+        case OType::REAL:
+        case OType::STR:
+        case OType::URI:
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    /// structural hash over otype, type name, and value (consistent with equals())
+    [[nodiscard]] size_t hash() const {
+      if(const size_t cached = this->hash_.load(std::memory_order_relaxed); 0 != cached)
+        return cached;
+      size_t h = this->value_hash();
+      h = hash_combine(hash_combine(std::hash<uint8_t>{}(static_cast<uint8_t>(this->otype)), h),
+                       std::hash<string>{}(this->tid->name()));
+      if(0 == h)
+        h = 1;
+      if(this->is_hash_cached())
+        this->hash_.store(h, std::memory_order_relaxed);
+      return h;
+    }
+
+    [[nodiscard]] size_t value_hash() const {
+      if(!this->value_.has_value())
+        return 0;
+      switch(this->otype) {
+        case OType::BOOL:
+          return std::hash<bool>{}(this->value<bool>());
+        case OType::INT:
+          return std::hash<FOS_INT_TYPE>{}(this->value<FOS_INT_TYPE>());
+        case OType::REAL: {
+          const FOS_REAL_TYPE r = this->value<FOS_REAL_TYPE>();
+          return std::hash<FOS_REAL_TYPE>{}(r == 0 ? 0 : r); // -0.0 == 0.0
+        }
+        case OType::STR: {
+          const auto *str = this->value_.get_if<string>();
+          return str ? std::hash<string>{}(*str) : 0;
+        }
+        case OType::URI: {
+          const auto *furi = this->value_.get_if<fURI>();
+          return furi ? furi->hash() : 0;
+        }
+        case OType::TYPE:
+          return this->type_value()->hash();
+        case OType::LST:
+        case OType::OBJS: {
+          size_t h = 0;
+          for(const Obj_p &o: *this->value<List_p<Obj_p>>()) {
+            h = hash_combine(h, o->hash());
+          }
+          return h;
+        }
+        case OType::REC: {
+          size_t h = 0;
+          for(const auto &[k, v]: *this->rec_value()) {
+            h = hash_combine(hash_combine(h, k->hash()), v->hash());
+          }
+          return h;
+        }
+        case OType::BCODE: {
+          size_t h = 0;
+          for(const Inst_p &i: *this->bcode_value()) {
+            h = hash_combine(h, i->hash());
+          }
+          return h;
+        }
+        case OType::INST:
+          return this->inst_args()->hash();
+        default:
+          return 0;
+      }
+    }
 
     [[nodiscard]] Obj_p inst_apply(const ID &inst_id, const List<Obj_p> &args = {}) const {
       return Obj::to_inst(Obj::to_inst_args(args), id_p(inst_id))->apply(this->shared_from_this());
@@ -1641,10 +1859,18 @@ namespace fhatos {
     }
 
     [[nodiscard]] bool equals(const Obj &other) const {
-      this->resolve();
-      other.resolve();
-      return this->otype == other.otype && this->tid->no_query().equals(other.tid->no_query()) &&
-             this->value_equals(other);
+      if(this == &other)
+        return true;
+      if(this->otype != other.otype)
+        return false;
+      // identical type ids resolve identically (skip the router round trip)
+      if(this->tid != other.tid && !this->tid->equals(*other.tid)) {
+        this->resolve();
+        other.resolve();
+        if(!this->tid->no_query().equals(other.tid->no_query()))
+          return false;
+      }
+      return this->value_equals(other);
     }
 
 
@@ -1658,24 +1884,25 @@ namespace fhatos {
       this->tid = other.tid;
       this->vid = other.vid;
       this->otype = other.otype;
+      this->hash_.store(0);
       switch(this->otype) {
         case OType::BOOL:
-          this->value_ = std::any(std::any_cast<bool>(other.value_));
+          this->value_ = std::any(other.value_.get<bool>());
         case OType::INT:
-          this->value_ = std::any(std::any_cast<FOS_INT_TYPE>(other.value_));
+          this->value_ = std::any(other.value_.get<FOS_INT_TYPE>());
         case OType::REAL:
-          this->value_ = std::any(std::any_cast<FOS_REAL_TYPE>(other.value_));
+          this->value_ = std::any(other.value_.get<FOS_REAL_TYPE>());
         case OType::STR:
-          this->value_ = std::any(std::string(std::any_cast<std::string>(other.value_)));
+          this->value_ = std::any(std::string(other.value_.get<std::string>()));
         case OType::URI:
-          this->value_ = std::any(fURI(std::any_cast<fURI>(other.value_)));
+          this->value_ = std::any(fURI(other.value_.get<fURI>()));
         case OType::OBJS:
         case OType::LST:
-          this->value_ = std::any(std::any_cast<List_p<Obj_p>>(other.value_));
+          this->value_ = std::any(other.value_.get<List_p<Obj_p>>());
         case OType::REC:
-          this->value_ = std::any(std::any_cast<RecMap_p<>>(other.value_));
+          this->value_ = std::any(other.value_.get<RecMap_p<>>());
         case OType::BCODE:
-          this->value_ = std::any(std::any_cast<InstList_p>(other.value_));
+          this->value_ = std::any(other.value_.get<InstList_p>());
         default:
           throw fError("unknown type during assignment operation: %s", OTypes.to_chars(this->otype));
       }
@@ -1963,6 +2190,7 @@ namespace fhatos {
           return Obj::to_rec(new_pairs, this->tid, this->vid);
         }
         case OType::INST: {
+          const bool domain_checked = std::exchange(DOMAIN_CHECKED, false);
           if(lhs->is_type()) {
             const Inst_p inst = Compiler().resolve_inst(lhs, this->shared_from_this());
             BCode_p body = lhs->type_value()->clone();
@@ -1972,7 +2200,9 @@ namespace fhatos {
           const Inst_p inst = Compiler().resolve_inst(lhs, this->shared_from_this());
           // TODO: type check should take coefficients into consideration
           //////////////////////////////////// DOMAIN TYPE CHECK ////////////////////////////////////
-          if(!lhs->is_noobj() || !inst->range_coefficient().first == 0)
+          if(domain_checked)
+            ++PROFILE_COUNTERS.type_checks_elided;
+          else if(!lhs->is_noobj() || !inst->range_coefficient().first == 0)
             Compiler(true).with_derivation_tree().type_check(lhs, *inst->domain());
           Obj_p result = ROUTER_EXEC_WITHIN_FRAME("#", inst->inst_args(), [this, inst, lhs]() {
             try {
@@ -2337,16 +2567,35 @@ namespace fhatos {
     }
 
     static Obj_p to_noobj() {
-      const static auto noobj = Obj::create(Any(nullptr), OType::NOOBJ, NOOBJ_FURI);
+      const static auto noobj = Obj::create(nullptr, OType::NOOBJ, NOOBJ_FURI);
       // id_p(NOOBJ_FURI->query({{"dc", "0,0"}, {"rc", "0,0"}})));
       return noobj;
     }
 
     static Bool_p to_bool(const bool value, const ID_p &typed_id = BOOL_FURI, const ID_p &value_id = nullptr) {
+      if(!value_id && (typed_id == BOOL_FURI || typed_id->equals(*BOOL_FURI))) {
+        // unnamed base bools are interned
+        static const Bool_p TRUE_BOOL = Obj::create(true, OType::BOOL, BOOL_FURI);
+        static const Bool_p FALSE_BOOL = Obj::create(false, OType::BOOL, BOOL_FURI);
+        return value ? TRUE_BOOL : FALSE_BOOL;
+      }
       return Obj::create(value, OType::BOOL, typed_id, value_id);
     }
 
     static Int_p to_int(const FOS_INT_TYPE value, const ID_p &type_id = INT_FURI, const ID_p &value_id = nullptr) {
+      if(!value_id && value >= FOS_INT_CACHE_MIN && value <= FOS_INT_CACHE_MAX &&
+         (type_id == INT_FURI || type_id->equals(*INT_FURI))) {
+        // unnamed small base ints are interned (objs are immutable so sharing is safe)
+        static const List<Int_p> SMALL_INTS = [] {
+          List<Int_p> ints;
+          ints.reserve(FOS_INT_CACHE_MAX - FOS_INT_CACHE_MIN + 1);
+          for(FOS_INT_TYPE i = FOS_INT_CACHE_MIN; i <= FOS_INT_CACHE_MAX; i++) {
+            ints.push_back(Obj::create(i, OType::INT, INT_FURI));
+          }
+          return ints;
+        }();
+        return SMALL_INTS.at(value - FOS_INT_CACHE_MIN);
+      }
       return Obj::create(value, OType::INT, type_id, value_id);
     }
 
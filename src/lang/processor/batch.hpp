@@ -0,0 +1,159 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#pragma once
+#ifndef fhatos_batch_hpp
+#define fhatos_batch_hpp
+
+#include "../../fhatos.hpp"
+#include "../obj.hpp"
+#include <optional>
+
+namespace fhatos {
+  enum class BatchOp { PLUS, MINUS, MULT, DIV, GT, GTE, LT, LTE, EQ, NEQ };
+
+  static const Map<string, BatchOp> BATCH_MAPS = {
+      {"plus", BatchOp::PLUS}, {"minus", BatchOp::MINUS}, {"mult", BatchOp::MULT}, {"div", BatchOp::DIV}};
+  static const Map<string, BatchOp> BATCH_FILTERS = {{"gt", BatchOp::GT},   {"gte", BatchOp::GTE}, {"lt", BatchOp::LT},
+                                                     {"lte", BatchOp::LTE}, {"eq", BatchOp::EQ},   {"neq", BatchOp::NEQ}};
+
+  /// columnar kernels for the processor's batch mode
+  /// a step is a pure numeric map (plus/minus/mult/div) or filter (is(gt/gte/lt/lte/eq/neq)) with a constant
+  /// argument of the column's base type (int or real). the kernels are plain loops over contiguous arrays so
+  /// the compiler can vectorize them.
+  class Batch {
+  public:
+    struct Step {
+      BatchOp op;
+      bool filter;
+      Obj_p rhs;
+    };
+
+    /// an obj that can be a column value (a base int or real without a value id)
+    static bool numeric(const Obj_p &obj) {
+      return (obj->is_int() || obj->is_real()) && !obj->vid && obj->tid->equals(*OTYPE_FURI.at(obj->otype));
+    }
+
+    static std::optional<Step> step(const Inst_p &inst, const OType otype) {
+      if(!inst->is_inst())
+        return std::nullopt;
+      const string op = inst->inst_op();
+      if(const auto it = BATCH_MAPS.find(op); it != BATCH_MAPS.end()) {
+        const Obj_p rhs = inst->inst_args()->arg(0);
+        if(!numeric(rhs) || rhs->otype != otype)
+          return std::nullopt;
+        // integer division by zero stays on the monad path
+        if(BatchOp::DIV == it->second && OType::INT == otype && 0 == rhs->int_value())
+          return std::nullopt;
+        return Step{it->second, false, rhs};
+      }
+      if("is" == op) {
+        Obj_p predicate = inst->inst_args()->arg(0);
+        if(predicate->is_bcode() && 1 == predicate->bcode_value()->size())
+          predicate = predicate->bcode_value()->front();
+        if(!predicate->is_inst())
+          return std::nullopt;
+        const auto it = BATCH_FILTERS.find(predicate->inst_op());
+        if(it == BATCH_FILTERS.end())
+          return std::nullopt;
+        const Obj_p rhs = predicate->inst_args()->arg(0);
+        if(!numeric(rhs) || rhs->otype != otype)
+          return std::nullopt;
+        return Step{it->second, true, rhs};
+      }
+      return std::nullopt;
+    }
+
+    template<typename T>
+    static void map(const BatchOp op, const T rhs, T *values, const size_t size) {
+      switch(op) {
+        case BatchOp::PLUS:
+          for(size_t i = 0; i < size; i++)
+            values[i] += rhs;
+          break;
+        case BatchOp::MINUS:
+          for(size_t i = 0; i < size; i++)
+            values[i] -= rhs;
+          break;
+        case BatchOp::MULT:
+          for(size_t i = 0; i < size; i++)
+            values[i] *= rhs;
+          break;
+        case BatchOp::DIV:
+          for(size_t i = 0; i < size; i++)
+            values[i] /= rhs;
+          break;
+        default:
+          throw fError("!y%i!! is not a batch map", static_cast<int>(op));
+      }
+    }
+
+    /// keep the values (and their bulks) that satisfy the predicate and return how many were kept
+    template<typename T>
+    static size_t filter(const BatchOp op, const T rhs, T *values, long *bulks, const size_t size) {
+      List<uint8_t> keep(size);
+      switch(op) {
+        case BatchOp::GT:
+          for(size_t i = 0; i < size; i++)
+            keep[i] = values[i] > rhs;
+          break;
+        case BatchOp::GTE:
+          for(size_t i = 0; i < size; i++)
+            keep[i] = values[i] >= rhs;
+          break;
+        case BatchOp::LT:
+          for(size_t i = 0; i < size; i++)
+            keep[i] = values[i] < rhs;
+          break;
+        case BatchOp::LTE:
+          for(size_t i = 0; i < size; i++)
+            keep[i] = values[i] <= rhs;
+          break;
+        case BatchOp::EQ:
+          for(size_t i = 0; i < size; i++)
+            keep[i] = values[i] == rhs;
+          break;
+        case BatchOp::NEQ:
+          for(size_t i = 0; i < size; i++)
+            keep[i] = values[i] != rhs;
+          break;
+        default:
+          throw fError("!y%i!! is not a batch filter", static_cast<int>(op));
+      }
+      size_t kept = 0;
+      for(size_t i = 0; i < size; i++) {
+        values[kept] = values[i];
+        bulks[kept] = bulks[i];
+        kept += keep[i];
+      }
+      return kept;
+    }
+
+    template<typename T>
+    static void apply(const Step &step, List<T> *values, List<long> *bulks) {
+      const T rhs = OType::INT == step.rhs->otype ? static_cast<T>(step.rhs->int_value())
+                                                  : static_cast<T>(step.rhs->real_value());
+      if(step.filter) {
+        const size_t kept = filter<T>(step.op, rhs, values->data(), bulks->data(), values->size());
+        values->resize(kept);
+        bulks->resize(kept);
+      } else
+        map<T>(step.op, rhs, values->data(), values->size());
+    }
+  };
+} // namespace fhatos
+#endif
@@ -0,0 +1,207 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#pragma once
+#ifndef fhatos_combiner_hpp
+#define fhatos_combiner_hpp
+
+#include "../../fhatos.hpp"
+#include "../obj.hpp"
+
+namespace fhatos {
+  class Combiner;
+  using Combiner_p = uptr<Combiner>;
+
+  /// a gather inst as a fold: create() is the initial accumulator, accumulate() folds in an obj (and its bulk),
+  /// merge() folds in another accumulator of the same inst (e.g. a worker's), and finish() is the gather's result.
+  /// barriers fold monads as they arrive rather than buffering them.
+  class Combiner {
+  public:
+    virtual ~Combiner() = default;
+
+    virtual void accumulate(const Obj_p &obj, long bulk) = 0;
+
+    virtual void merge(const Combiner &other) = 0;
+
+    [[nodiscard]] virtual Obj_p finish() const = 0;
+
+    /// the combiner of a gather inst (nullptr if the inst buffers its objs)
+    static Combiner_p create(const string &op);
+
+    /// fold a buffered objs (how the gather insts are applied outside a processor)
+    static Obj_p fold(const string &op, const Objs_p &objs) {
+      const Combiner_p combiner = Combiner::create(op);
+      for(const Obj_p &obj: *objs->objs_value()) {
+        combiner->accumulate(obj, 1);
+      }
+      return combiner->finish();
+    }
+
+  protected:
+    /// a base int/real (no value id) whose value can be folded natively
+    static bool native(const Obj_p &obj, const OType otype) {
+      return obj->otype == otype && !obj->vid && obj->tid->equals(*OTYPE_FURI.at(otype));
+    }
+  };
+
+  class CountCombiner final : public Combiner {
+    long count_ = 0;
+
+  public:
+    void accumulate(const Obj_p &, const long bulk) override { this->count_ += bulk; }
+
+    void merge(const Combiner &other) override { this->count_ += static_cast<const CountCombiner &>(other).count_; }
+
+    [[nodiscard]] Obj_p finish() const override { return Obj::to_int(static_cast<FOS_INT_TYPE>(this->count_)); }
+  };
+
+  /// sum (plus) and prod (mult): native int/real arithmetic until a non-numeric obj arrives
+  class ArithmeticCombiner final : public Combiner {
+    enum class State { EMPTY, INT, REAL, OBJ };
+
+    const bool product_;
+    State state_ = State::EMPTY;
+    FOS_INT_TYPE int_ = 0;
+    FOS_REAL_TYPE real_ = 0;
+    Obj_p obj_ = nullptr;
+
+    [[nodiscard]] Obj_p current() const {
+      switch(this->state_) {
+        case State::INT:
+          return Obj::to_int(this->int_);
+        case State::REAL:
+          return Obj::to_real(this->real_);
+        case State::OBJ:
+          return this->obj_;
+        default:
+          return nullptr;
+      }
+    }
+
+    /// the generic fold (each obj re-resolves plus/mult against the accumulator)
+    void apply(const Obj_p &obj) {
+      const Obj_p acc = this->current();
+      this->obj_ = acc ? acc->inst_apply(this->product_ ? "mult" : "plus", {obj}) : obj;
+      this->state_ = State::OBJ;
+    }
+
+    template<typename T>
+    [[nodiscard]] T fold(T acc, const T value, const long bulk) const {
+      for(long i = 0; i < bulk; i++) {
+        acc = this->product_ ? acc * value : acc + value;
+      }
+      return acc;
+    }
+
+  public:
+    explicit ArithmeticCombiner(const bool product) : product_(product) {}
+
+    void accumulate(const Obj_p &obj, const long bulk) override {
+      if((State::EMPTY == this->state_ || State::INT == this->state_) && native(obj, OType::INT)) {
+        const FOS_INT_TYPE value = obj->int_value();
+        if(State::EMPTY == this->state_)
+          this->int_ = this->product_ ? this->fold<FOS_INT_TYPE>(value, value, bulk - 1)
+                                      : value * static_cast<FOS_INT_TYPE>(bulk);
+        else
+          this->int_ = this->product_ ? this->fold<FOS_INT_TYPE>(this->int_, value, bulk)
+                                      : this->int_ + value * static_cast<FOS_INT_TYPE>(bulk);
+        this->state_ = State::INT;
+      } else if((State::EMPTY == this->state_ || State::REAL == this->state_) && native(obj, OType::REAL)) {
+        const FOS_REAL_TYPE value = obj->real_value();
+        if(State::EMPTY == this->state_)
+          this->real_ = this->product_ ? this->fold<FOS_REAL_TYPE>(value, value, bulk - 1)
+                                       : value * static_cast<FOS_REAL_TYPE>(bulk);
+        else
+          this->real_ = this->product_ ? this->fold<FOS_REAL_TYPE>(this->real_, value, bulk)
+                                       : this->real_ + value * static_cast<FOS_REAL_TYPE>(bulk);
+        this->state_ = State::REAL;
+      } else {
+        for(long i = 0; i < bulk; i++) {
+          this->apply(obj);
+        }
+      }
+    }
+
+    void merge(const Combiner &other) override {
+      if(const Obj_p partial = other.finish(); !partial->is_noobj())
+        this->accumulate(partial, 1);
+    }
+
+    [[nodiscard]] Obj_p finish() const override {
+      const Obj_p result = this->current();
+      return result ? result : Obj::to_noobj();
+    }
+  };
+
+  /// min and max (objs are compared with their relational operators)
+  class ExtremumCombiner final : public Combiner {
+    const bool max_;
+    Obj_p obj_ = nullptr;
+
+  public:
+    explicit ExtremumCombiner(const bool max) : max_(max) {}
+
+    void accumulate(const Obj_p &obj, const long) override {
+      if(!this->obj_ || (this->max_ ? *obj > *this->obj_ : *obj < *this->obj_))
+        this->obj_ = obj;
+    }
+
+    void merge(const Combiner &other) override {
+      if(const Obj_p partial = static_cast<const ExtremumCombiner &>(other).obj_)
+        this->accumulate(partial, 1);
+    }
+
+    [[nodiscard]] Obj_p finish() const override { return this->obj_ ? this->obj_ : Obj::to_noobj(); }
+  };
+
+  class MeanCombiner final : public Combiner {
+    double sum_ = 0;
+    long count_ = 0;
+
+  public:
+    void accumulate(const Obj_p &obj, const long bulk) override {
+      if(!obj->is_int() && !obj->is_real())
+        throw fError("!ymean!! requires !bint!! or !breal!! objs: %s", obj->toString().c_str());
+      this->sum_ += (obj->is_int() ? obj->int_value() : obj->real_value()) * static_cast<double>(bulk);
+      this->count_ += bulk;
+    }
+
+    void merge(const Combiner &other) override {
+      const auto &mean = static_cast<const MeanCombiner &>(other);
+      this->sum_ += mean.sum_;
+      this->count_ += mean.count_;
+    }
+
+    [[nodiscard]] Obj_p finish() const override {
+      return 0 == this->count_ ? Obj::to_noobj()
+                               : Obj::to_real(static_cast<FOS_REAL_TYPE>(this->sum_ / static_cast<double>(this->count_)));
+    }
+  };
+
+  inline Combiner_p Combiner::create(const string &op) {
+    static const Map<string, Supplier<Combiner_p>> COMBINERS = {
+        {"count", [] { return make_unique<CountCombiner>(); }},
+        {"sum", [] { return make_unique<ArithmeticCombiner>(false); }},
+        {"prod", [] { return make_unique<ArithmeticCombiner>(true); }},
+        {"min", [] { return make_unique<ExtremumCombiner>(false); }},
+        {"max", [] { return make_unique<ExtremumCombiner>(true); }},
+        {"mean", [] { return make_unique<MeanCombiner>(); }}};
+    const auto it = COMBINERS.find(op);
+    return it == COMBINERS.end() ? nullptr : it->second();
+  }
+} // namespace fhatos
+#endif
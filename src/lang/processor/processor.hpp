@@ -22,14 +22,29 @@
 #define CUSTOM_STACK_NAME "custom_stack"
 
 #include "../../fhatos.hpp"
+#include "../../model/fos/sys/router/router.hpp"
 #include "../../model/fos/sys/scheduler/thread/thread.hpp"
 #include "../mmadt/compiler.hpp"
 #include "../mmadt/rewriter.hpp"
 #include "../obj.hpp"
+#include "../../util/lru_cache.hpp"
+#include "batch.hpp"
+#include "combiner.hpp"
+#include "profiler.hpp"
+#include <thread>
+#include <unordered_set>
 
 #define PROCESSOR_TID "/mmadt/util/proc"
+#ifndef FOS_PLAN_CACHE_SIZE
+#define FOS_PLAN_CACHE_SIZE 128
+#endif
 
 namespace fhatos {
+  /// the number of threads a processor runs its monads on when a query doesn't specify its own parallelism
+  inline atomic<uint8_t> PROCESSOR_PARALLELISM{1};
+  /// type check every inst's domain (debugging) rather than skipping the checks type inference proves
+  inline atomic<bool> PROCESSOR_FULL_TYPE_CHECKS{false};
+
   ///////////////////////////////////////////////////////////////////////////
   /////////////////////////////// PROCESSOR /////////////////////////////////
   ///////////////////////////////////////////////////////////////////////////
@@ -39,32 +54,73 @@ namespace fhatos {
   public:
     class MonadSet;
     class Monad;
+    struct Worker;
     using Monad_p = ptr<Processor::Monad>;
     uptr<Compiler> compiler_;
 
   protected:
     BCode_p bcode_;
-    // unique_ptr<MonadSet> running_ = make_unique<MonadSet>();
-    unique_ptr<Deque<Monad_p>> running_ = make_unique<Deque<Monad_p>>();
+    /// merge equal obj@inst monads into a single bulked monad
+    const bool bulk_;
+    /// run pending int/real monads through consecutive numeric insts as columns
+    const bool batch_;
+    unique_ptr<MonadSet> running_;
     unique_ptr<Deque<Monad_p>> barriers_ = make_unique<Deque<Monad_p>>();
-    unique_ptr<Deque<Obj_p>> halted_ = make_unique<Deque<Obj_p>>();
-    // unique_ptr<ObjsSet> halted_ = make_unique<ObjsSet>();
+    unique_ptr<List<long>> barrier_bulks_ = make_unique<List<long>>(); // the bulk of each obj in the front barrier
+    /// the fold of the front barrier's objs (nullptr while its gather inst buffers them)
+    mutable Combiner_p combiner_;
+    unique_ptr<Deque<Pair<Obj_p, long>>> halted_ = make_unique<Deque<Pair<Obj_p, long>>>();
+    /// the number of work-stealing workers the running monads are spread across (1 is serial)
+    const uint8_t parallelism_;
+    /// guards the halted monads and the front barrier while workers are running
+    mutable Mutex sync_;
+    /// the queued and in-flight monads of all workers (the workers stop when it reaches 0)
+    mutable atomic<long> pending_{0};
+    /// stop after the first halted obj (the submitted bcode's range coefficient is {0,1} or {1,1})
+    const bool single_;
+    /// the remaining bulk each limit inst lets through
+    mutable Map<const Obj *, long> limits_;
+    /// while streaming, the monads spawned by the running monad (they run before its siblings)
+    mutable List<Monad_p> *spawned_ = nullptr;
+    /// the bcode ended with profile() (the processor's result is a rec of its inst profiles)
+    bool profiling_ = false;
+    mutable Map<const Obj *, InstProfile> profiles_;
+    /// the insts whose domain check type inference proved for objs of a base type (and the domain that accepts them)
+    Map<const Obj *, OType> proven_;
+    /// the domain checks skipped by this processor
+    mutable atomic<long> elided_{0};
+    /// the total bulk of the (non-dead) monads the current thread has emitted
+    inline static thread_local long EMITTED = 0;
+    /// the processor (and worker) the current thread is running monads for
+    inline static thread_local Pair<const Processor *, Worker *> WORKER = {nullptr, nullptr};
 
   public:
-    explicit Processor(const BCode_p &bcode) :
+    /// parallelism 0 uses PROCESSOR_PARALLELISM (processors nested in a worker always run serially)
+    /// a planned bcode is already rewritten (see Processor::plan())
+    explicit Processor(const BCode_p &bcode, const bool bulk = false, const bool batch = false,
+                       const uint8_t parallelism = 0, const bool planned = false) :
         Obj(Any(), OType::OBJ, REC_FURI, id_p(Processor::get_core_id())), compiler_(make_unique<Compiler>()),
-        bcode_(bcode) {
+        bcode_(bcode), bulk_(bulk), batch_(batch), running_(make_unique<MonadSet>(bulk)),
+        parallelism_(WORKER.first ? 1 : (parallelism > 0 ? parallelism : PROCESSOR_PARALLELISM.load())),
+        single_(bcode->tid->has_query(FOS_RNG_COEF) && bcode->range_coefficient().second <= 1) {
       if(!this->bcode_->is_code()) {
         if(!this->bcode_->is_noobj()) {
           // monad halts immediately on a non-bcode submission
-          this->halted_->push_back(bcode);
+          this->halted_->push_back({bcode, 1});
         }
       } else {
         // if a single inst, wrap in bcode
         if(this->bcode_->is_inst())
           this->bcode_ = Obj::to_bcode({this->bcode_});
-        // process bcode inst pipeline
-        this->bcode_ = Rewriter({Rewriter::by(), Rewriter::explain()}).apply(this->bcode_);
+        // a terminal profile() is replaced by the processor measuring its insts
+        if(const InstList_p insts = this->bcode_->bcode_value();
+           insts->size() > 1 && "profile" == insts->back()->inst_op()) {
+          this->bcode_ = Obj::to_bcode(List<Inst_p>(insts->begin(), insts->end() - 1));
+          this->profiling_ = true;
+        }
+        // process bcode inst pipeline (batches and profiles run unfused insts)
+        if(!planned)
+          this->bcode_ = Processor::rewriter(!this->batch_ && !this->profiling_).apply(this->bcode_);
         // setup global behavior around barriers, initials, and terminals
         LOG_WRITE(DEBUG, this, L(FOS_TAB_2 "loading {}\n", this->bcode_->toString()));
         bool first = true;
@@ -88,6 +144,8 @@ namespace fhatos {
           }
           first = false;
         }
+        if(!PROCESSOR_FULL_TYPE_CHECKS.load())
+          this->infer_types();
         // start inst forced initial TODO: remove this as it's not sound
         if(this->running_->empty()) {
           // const Obj_p seed_copy = Objs::to_objs();
@@ -97,6 +155,9 @@ namespace fhatos {
       }
     }
 
+    /// the domain checks skipped as proven by type inference
+    [[nodiscard]] long type_checks_elided() const { return this->elided_.load(); }
+
     static fURI get_core_id(const string &postfix = "") {
       const fURI i = ID("/sys/vm/core").append(to_string(Thread::core_current_thread()));
       return postfix.empty() ? i : i.extend(postfix);
@@ -109,41 +170,112 @@ namespace fhatos {
     }
 
 
-    [[nodiscard]] Obj_p next(const int steps = -1) const {
+    /// the next halted obj and its bulk ({nullptr,0} when the processor is exhausted)
+    /// only as many monads are run as needed to halt the next obj
+    [[nodiscard]] Pair<Obj_p, long> next_bulked(const int steps = -1) const {
       while(true) {
         // Process::current_process()->feed_watchdog_via_counter();
         if(this->halted_->empty()) {
-          if(this->running_->empty())
-            return nullptr;
-          this->execute(steps);
+          if(this->running_->empty() && this->barriers_->empty())
+            return {nullptr, 0};
+          this->execute(steps, true);
         } else {
-          const Obj_p end = this->halted_->front();
+          const Pair<Obj_p, long> end = this->halted_->front();
           this->halted_->pop_front();
-          LOG_WRITE(TRACE, vri(this->vid_or_tid()).get(), L(FOS_TAB_2 "!ghalting!! monad at {}\n", end->toString()));
-          if(!end->is_noobj())
+          LOG_WRITE(TRACE, vri(this->vid_or_tid()).get(),
+                    L(FOS_TAB_2 "!ghalting!! monad at {} [!ybulk!!:{}]\n", end.first->toString(), end.second));
+          if(!end.first->is_noobj()) {
+            if(this->single_)
+              this->stop();
             return end;
+          }
         }
       }
     }
 
+    /// drop all remaining work
+    void stop() const {
+      this->running_->clear();
+      this->barriers_->clear();
+      this->barrier_bulks_->clear();
+      this->combiner_.reset();
+      this->halted_->clear();
+    }
+
+    [[nodiscard]] Obj_p next(const int steps = -1) const {
+      const auto [end, bulk] = this->next_bulked(steps);
+      if(bulk > 1)
+        this->halted_->push_front({end, bulk - 1});
+      return end;
+    }
+
     [[nodiscard]] Objs_p to_objs() const {
+      const auto start = std::chrono::steady_clock::now();
       const Objs_p objs = Obj::to_objs();
-      Obj_p end;
-      while(nullptr != (end = this->next())) {
-        objs->add_obj(end);
+      if(!this->single_)
+        this->execute();
+      Pair<Obj_p, long> end;
+      while(nullptr != (end = this->next_bulked()).first) {
+        for(long i = 0; i < end.second; i++) {
+          objs->add_obj(end.first);
+        }
       }
       LOG_WRITE(TRACE, vri(this->vid_or_tid()).get(),
                 L("{}\n", Ansi<>::singleton()->silly_print("processor shutting down", true, false)));
-      return objs;
+      if(!this->profiling_)
+        return objs;
+      return Obj::to_objs({this->profile(objs, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                   std::chrono::steady_clock::now() - start).count())});
+    }
+
+    /// the results with the per inst profile of the bcode (in bcode order)
+    [[nodiscard]] Rec_p profile(const Objs_p &results, const uint64_t wall_ns) const {
+      const Lst_p insts = Obj::to_lst();
+      for(const Inst_p &inst: *this->bcode_->bcode_value()) {
+        const auto it = this->profiles_.find(inst.get());
+        const Rec_p rec = Obj::to_rec({{"inst", inst}});
+        rec->rec_merge((it == this->profiles_.end() ? InstProfile() : it->second).to_rec()->rec_value());
+        insts->lst_add(rec);
+      }
+      return Obj::to_rec({{"result", Obj::to_lst(results->objs_value())},
+                          {"wall_ms", Obj::to_real(static_cast<FOS_REAL_TYPE>(wall_ns / 1000000.0))},
+                          {"insts", insts}});
     }
 
-    void execute(const int steps = -1) const {
+    /// add a monad step's measurements to its inst's profile
+    void profile(const Inst_p &inst, const InstProfile &step) const {
+      if(WORKER.first == this)
+        WORKER.second->profiles[inst.get()].merge(step);
+      else
+        this->profiles_[inst.get()].merge(step);
+    }
+
+    /// run monads (breadth-first) or, when until_halt, depth-first until an obj halts
+    void execute(const int steps = -1, const bool until_halt = false) const {
+      if(this->parallelism_ > 1 && -1 == steps) {
+        this->execute_parallel();
+        return;
+      }
       uint16_t counter = 0;
-      while((!this->running_->empty() || !this->barriers_->empty()) && (counter++ < steps || steps == -1)) {
+      while((!this->running_->empty() || !this->barriers_->empty()) && (counter++ < steps || steps == -1) &&
+            !(until_halt && !this->halted_->empty())) {
         if(!this->running_->empty()) {
-          const Monad_p m = this->running_->front();
-          this->running_->pop_front();
-          m->loop();
+          if(this->batch_ && !this->profiling_ && this->execute_batch())
+            continue;
+          const Monad_p m = this->running_->next();
+          if(until_halt) {
+            List<Monad_p> spawned;
+            this->spawned_ = &spawned;
+            try {
+              m->loop();
+            } catch(...) {
+              this->spawned_ = nullptr;
+              throw;
+            }
+            this->spawned_ = nullptr;
+            this->running_->push_front(spawned);
+          } else
+            m->loop();
         } else if(!this->barriers_->empty()) {
           const Monad_p barrier = this->barriers_->front();
           this->barriers_->pop_front();
@@ -156,6 +288,377 @@ namespace fhatos {
                   this->halted_->size(), this->bcode_->toString()));
     }
 
+    /// run the running monads on the workers until none remain, then process the next barrier (serially)
+    void execute_parallel() const {
+      while(!this->running_->empty() || !this->barriers_->empty()) {
+        if(!this->running_->empty())
+          this->run_workers();
+        else {
+          const Monad_p barrier = this->barriers_->front();
+          this->barriers_->pop_front();
+          LOG_WRITE(DEBUG, this, L("processing barrier: {}\n", barrier->toString()));
+          barrier->loop();
+        }
+      }
+      LOG_WRITE(TRACE, this,
+                L(FOS_TAB_2 "exiting parallel run with [!ghalted!!:{}] [!yworkers!!:{}]: {}\n", this->halted_->size(),
+                  this->parallelism_, this->bcode_->toString()));
+    }
+
+    /// deal the running monads across the workers and run them (the calling thread is worker 0)
+    void run_workers() const {
+      List<uptr<Worker>> workers;
+      for(uint8_t i = 0; i < this->parallelism_; i++) {
+        workers.push_back(make_unique<Worker>(this->bulk_));
+      }
+      for(size_t i = 0; !this->running_->empty(); i++) {
+        if(workers.at(i % workers.size())->running.push_back(this->running_->next()))
+          ++this->pending_;
+      }
+      // workers see the caller's frame bindings
+      const FrameStack frames = Router::get_frame();
+      std::exception_ptr error = nullptr;
+      atomic<bool> failed{false};
+      const auto work = [this, &workers, &frames, &error, &failed](const size_t id) {
+        const Pair<const Processor *, Worker *> prior = WORKER;
+        WORKER = {this, workers.at(id).get()};
+        const FrameStack prior_frames = Router::get_frame();
+        Router::get_frame() = frames;
+        while(this->pending_.load() > 0 && !failed.load()) {
+          const Monad_p monad = Processor::take(workers, id);
+          if(!monad) {
+            std::this_thread::yield();
+            continue;
+          }
+          try {
+            monad->loop();
+          } catch(...) {
+            auto lock = std::lock_guard<Mutex>(this->sync_);
+            if(!error)
+              error = std::current_exception();
+            failed = true;
+          }
+          --this->pending_;
+        }
+        Router::get_frame() = prior_frames;
+        WORKER = prior;
+      };
+      List<std::thread> threads;
+      for(size_t id = 1; id < workers.size(); id++) {
+        threads.emplace_back(work, id);
+      }
+      work(0);
+      for(std::thread &thread: threads) {
+        thread.join();
+      }
+      this->pending_ = 0;
+      // fold the workers' partial aggregates into the front barrier's
+      for(const uptr<Worker> &worker: workers) {
+        if(!worker->combiner)
+          continue;
+        if(this->combiner_)
+          this->combiner_->merge(*worker->combiner);
+        else
+          this->combiner_ = std::move(worker->combiner);
+      }
+      for(const uptr<Worker> &worker: workers) {
+        for(const auto &[inst, profile]: worker->profiles) {
+          this->profiles_[inst].merge(profile);
+        }
+      }
+      if(error)
+        std::rethrow_exception(error);
+    }
+
+    /// the worker's oldest monad or (when it has none) the newest monad stolen from another worker
+    static Monad_p take(const List<uptr<Worker>> &workers, const size_t id) {
+      for(size_t i = 0; i < workers.size(); i++) {
+        Worker *worker = workers.at((id + i) % workers.size()).get();
+        auto lock = std::lock_guard<Mutex>(worker->mutex);
+        if(!worker->running.empty())
+          return 0 == i ? worker->running.next() : worker->running.pop_back();
+      }
+      return nullptr;
+    }
+
+    [[nodiscard]] Compiler *compiler() const {
+      return WORKER.first == this ? WORKER.second->compiler.get() : this->compiler_.get();
+    }
+
+    /// queue a monad on the current thread's worker (or the running set when serial)
+    void emit(const Monad_p &monad) const {
+      if(!monad->dead())
+        EMITTED += monad->bulk;
+      if(WORKER.first == this) {
+        auto lock = std::lock_guard<Mutex>(WORKER.second->mutex);
+        if(WORKER.second->running.push_back(monad))
+          ++this->pending_;
+      } else if(this->spawned_)
+        this->spawned_->push_back(monad);
+      else
+        this->running_->push_back(monad);
+    }
+
+    /// the base type of a value type id (e.g. an inst's declared range)
+    static Option<OType> base_otype(const fURI &type_id) {
+      for(const OType otype: {OType::BOOL, OType::INT, OType::REAL, OType::STR, OType::URI}) {
+        if(type_id.equals(*OTYPE_FURI.at(otype)))
+          return otype;
+      }
+      return {};
+    }
+
+    static bool closed(const string &op) { return "plus" == op || "minus" == op || "mult" == op; }
+
+    /// propagate the base type of the objs flowing from inst to inst (from a start of base values through each
+    /// inst's declared range) and prove the domain checks of the insts that accept it
+    void infer_types() {
+      Option<OType> known;
+      for(const Inst_p &inst: *this->bcode_->bcode_value()) {
+        Inst_p resolved = nullptr;
+        try {
+          if(known)
+            resolved = Compiler().resolve_inst(Obj::to_type(OTYPE_FURI.at(known.value())), inst);
+        } catch(const fError &) {
+          // resolved (and checked) at runtime
+        }
+        if(resolved && !resolved->is_gather()) {
+          const fURI domain = resolved->domain()->no_query();
+          if(domain.equals(*OBJ_FURI) || domain.equals(*OTYPE_FURI.at(known.value())))
+            this->proven_.insert({inst.get(), known.value()});
+        }
+        const string op = inst->inst_op();
+        if("start" == op) {
+          known = {};
+          for(const auto &[k, arg]: *inst->inst_args()->rec_value()) {
+            for(const Obj_p &obj: arg->is_objs() ? *arg->objs_value() : List<Obj_p>{arg}) {
+              const Option<OType> otype = obj->vid ? Option<OType>() : Processor::base_otype(*obj->tid);
+              if(!otype || (known && known.value() != otype.value()) || obj->is_code()) {
+                known = {};
+                break;
+              }
+              known = otype;
+            }
+            if(!known)
+              break;
+          }
+        } else if(Processor::closed(op)) {
+          // arithmetic over args of the lhs' base type is closed (whatever range the inst declares)
+          for(const auto &[k, arg]: *inst->inst_args()->rec_value()) {
+            if(known && (arg->vid || arg->otype != known.value() || !arg->is_base_type()))
+              known = {};
+          }
+        } else if("is" != op && !Processor::is_limit(inst))
+          known = resolved ? Processor::base_otype(resolved->range()->no_query()) : Option<OType>();
+      }
+    }
+
+    /// a monad's domain check is skipped when its obj is of the base type inference proved for the inst and
+    /// the inst resolved (for the value) to a domain that base type satisfies
+    bool proven(const Inst_p &inst, const Obj_p &obj, const Inst_p &resolved) const {
+      const auto it = this->proven_.find(inst.get());
+      if(it == this->proven_.end() || it->second != obj->otype || obj->vid || !obj->is_base_type())
+        return false;
+      const fURI domain = resolved->domain()->no_query();
+      if(!domain.equals(*OBJ_FURI) && !domain.equals(*OTYPE_FURI.at(obj->otype)))
+        return false;
+      ++this->elided_;
+      return true;
+    }
+
+    static bool is_limit(const Inst_p &inst) {
+      const string op = inst->inst_op();
+      return "limit" == op || "take" == op;
+    }
+
+    /// the part of a monad's bulk that a limit inst lets through
+    [[nodiscard]] long admit(const Inst_p &limit, const long bulk) const {
+      const auto lock =
+          WORKER.first == this ? std::unique_lock<Mutex>(this->sync_) : std::unique_lock<Mutex>();
+      auto it = this->limits_.find(limit.get());
+      if(it == this->limits_.end()) {
+        const Obj_p n = limit->inst_args()->arg(0);
+        if(!n->is_int())
+          throw fError("!y%s!! requires an !bint!! argument: %s", limit->inst_op().c_str(), n->toString().c_str());
+        it = this->limits_.emplace(limit.get(), std::max<long>(0, n->int_value())).first;
+      }
+      const long admitted = std::min(bulk, it->second);
+      it->second -= admitted;
+      if(admitted > 0 && 0 == it->second && WORKER.first != this)
+        this->prune(limit);
+      return admitted;
+    }
+
+    /// drop the monads and barriers upstream of an exhausted limit (all they could produce would be dropped)
+    void prune(const Inst_p &limit) const {
+      const InstList_p insts = this->bcode_->bcode_value();
+      const auto position = [&insts](const Inst_p &inst) {
+        return static_cast<size_t>(std::find(insts->begin(), insts->end(), inst) - insts->begin());
+      };
+      const size_t at = position(limit);
+      if(at == insts->size())
+        return;
+      const List<Monad_p> dropped =
+          this->running_->extract_if([&position, at](const Monad_p &m) { return position(m->inst) <= at; });
+      if(!this->barriers_->empty() && position(this->barriers_->front()->inst) < at) {
+        this->barrier_bulks_->clear();
+        this->combiner_.reset();
+      }
+      this->barriers_->erase(std::remove_if(this->barriers_->begin(), this->barriers_->end(),
+                                            [&position, at](const Monad_p &b) { return position(b->inst) < at; }),
+                             this->barriers_->end());
+      LOG_WRITE(DEBUG, this,
+                L("{} exhausted: {} upstream monads dropped\n", limit->toString(), dropped.size()));
+    }
+
+    void halt(const Obj_p &obj, const long bulk) const {
+      if(WORKER.first == this) {
+        auto lock = std::lock_guard<Mutex>(this->sync_);
+        this->halted_->push_back({obj, bulk});
+      } else
+        this->halted_->push_back({obj, bulk});
+    }
+
+    /// run the front monad, and every pending monad at its inst with the same numeric type, through the
+    /// consecutive batchable insts as one column (false if the front monad is not batchable)
+    [[nodiscard]] bool execute_batch() const {
+      const Monad_p front = this->running_->front();
+      if(front->halted() || !Batch::numeric(front->obj))
+        return false;
+      const Inst_p start = front->inst;
+      const OType otype = front->obj->otype;
+      const std::optional<Batch::Step> step = Batch::step(start, otype);
+      if(!step || !this->batchable(front->obj, start))
+        return false;
+      const List<Monad_p> monads = this->running_->extract_if([&start, otype](const Monad_p &m) {
+        return m->inst == start && m->obj->otype == otype && Batch::numeric(m->obj);
+      });
+      List<long> bulks;
+      bulks.reserve(monads.size());
+      for(const Monad_p &m: monads) {
+        bulks.push_back(m->bulk);
+      }
+      if(OType::INT == otype) {
+        List<FOS_INT_TYPE> values;
+        values.reserve(monads.size());
+        for(const Monad_p &m: monads) {
+          values.push_back(m->obj->int_value());
+        }
+        const Inst_p next_inst = this->run_column<FOS_INT_TYPE>(front->obj, start, *step, &values, &bulks);
+        for(size_t i = 0; i < values.size(); i++) {
+          this->running_->push_back(this->M(Obj::to_int(values.at(i)), next_inst, bulks.at(i)));
+        }
+      } else {
+        List<FOS_REAL_TYPE> values;
+        values.reserve(monads.size());
+        for(const Monad_p &m: monads) {
+          values.push_back(m->obj->real_value());
+        }
+        const Inst_p next_inst = this->run_column<FOS_REAL_TYPE>(front->obj, start, *step, &values, &bulks);
+        for(size_t i = 0; i < values.size(); i++) {
+          this->running_->push_back(this->M(Obj::to_real(values.at(i)), next_inst, bulks.at(i)));
+        }
+      }
+      return true;
+    }
+
+    /// the inst resolves to a builtin mmadt inst (no user type overrides it for this obj)
+    [[nodiscard]] bool batchable(const Obj_p &sample, const Inst_p &inst) const {
+      return this->compiler_->resolve_inst(sample, inst)->tid->starts_with(MMADT_SCHEME "/");
+    }
+
+    /// apply every consecutive batchable step to the column and return the inst its values migrate to
+    template<typename T>
+    [[nodiscard]] Inst_p run_column(const Obj_p &sample, const Inst_p &start, const Batch::Step &first, List<T> *values,
+                                    List<long> *bulks) const {
+      Inst_p inst = start;
+      std::optional<Batch::Step> step = first;
+      while(step) {
+        Batch::apply<T>(*step, values, bulks);
+        inst = this->bcode_->next_inst(inst);
+        if(inst->is_generative()) {
+          // the monads die (as in Monad::range_loop)
+          values->clear();
+          bulks->clear();
+          return inst;
+        }
+        step = Batch::step(inst, sample->otype);
+        if(step && !this->batchable(sample, inst))
+          step = std::nullopt;
+      }
+      return inst;
+    }
+
+    /// the combiner of a builtin gather inst (nullptr if the inst is overridden or buffers its objs)
+    static Combiner_p combiner(const Inst_p &gather) {
+      return gather->tid->starts_with(MMADT_SCHEME "/") ? Combiner::create(gather->inst_op()) : nullptr;
+    }
+
+    /// fold a monad's obj into the front barrier (or, if its gather inst has no combiner, add it to the barrier)
+    /// workers fold into their own combiner which is merged into the processor's when the workers join
+    void gather(const Inst_p &inst, const Obj_p &obj, const long bulk) const {
+      // as Obj::add_obj() (noobjs are dropped and objs are flattened)
+      if(obj->is_noobj())
+        return;
+      if(obj->is_objs()) {
+        for(const Obj_p &o: *obj->objs_value()) {
+          this->gather(inst, o, bulk);
+        }
+        return;
+      }
+      if(WORKER.first == this) {
+        Worker *worker = WORKER.second;
+        if(!worker->combiner)
+          worker->combiner = Processor::combiner(inst);
+        if(worker->combiner) {
+          worker->combiner->accumulate(obj, bulk);
+          return;
+        }
+        auto lock = std::lock_guard<Mutex>(this->sync_);
+        this->gather_unlocked(obj, bulk);
+      } else {
+        if(!this->combiner_)
+          this->combiner_ = Processor::combiner(inst);
+        if(this->combiner_) {
+          this->combiner_->accumulate(obj, bulk);
+          return;
+        }
+        this->gather_unlocked(obj, bulk);
+      }
+    }
+
+    void gather_unlocked(const Obj_p &obj, const long bulk) const {
+      const Objs_p barrier = this->barriers_->front()->obj;
+      const size_t size = barrier->objs_value()->size();
+      barrier->add_obj(obj);
+      if(this->bulk_)
+        this->barrier_bulks_->insert(this->barrier_bulks_->end(), barrier->objs_value()->size() - size, bulk);
+    }
+
+    /// apply a barrier inst to its gathered objs (a folded barrier is finished rather than applied)
+    [[nodiscard]] Obj_p apply_barrier(const Inst_p &inst, const Objs_p &objs) const {
+      const List<long> bulks = std::move(*this->barrier_bulks_);
+      this->barrier_bulks_->clear();
+      const List_p<Obj_p> gathered = objs->objs_value();
+      const bool bulked = this->bulk_ && !bulks.empty() && bulks.size() == gathered->size();
+      if(this->combiner_) {
+        const Combiner_p combiner = std::move(this->combiner_);
+        for(size_t i = 0; i < gathered->size(); i++) {
+          combiner->accumulate(gathered->at(i), bulked ? bulks.at(i) : 1);
+        }
+        return combiner->finish();
+      }
+      if(!bulked)
+        return inst->apply(objs);
+      const Objs_p expanded = Obj::to_objs();
+      for(size_t i = 0; i < gathered->size(); i++) {
+        for(long j = 0; j < bulks.at(i); j++) {
+          expanded->add_obj(gathered->at(i));
+        }
+      }
+      return inst->apply(expanded);
+    }
+
   public:
     [[nodiscard]] MonadSet make_monad_set() { return MonadSet(); }
 
@@ -163,21 +666,128 @@ namespace fhatos {
       return make_shared<Monad>(this, obj, inst);
     }
 
-    static Objs_p compute(const BCode_p &bcode) {
+    /// an input iterator over the processor's halted objs (each increment runs only what the next obj needs)
+    class Cursor {
+      const Processor *processor_;
+      Obj_p current_;
+
+    public:
+      using iterator_category = std::input_iterator_tag;
+      using value_type = Obj_p;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const Obj_p *;
+      using reference = const Obj_p &;
+
+      explicit Cursor(const Processor *processor) : processor_(processor) {
+        if(this->processor_)
+          ++*this;
+      }
+
+      reference operator*() const { return this->current_; }
+
+      pointer operator->() const { return &this->current_; }
+
+      Cursor &operator++() {
+        this->current_ = this->processor_->next();
+        if(!this->current_)
+          this->processor_ = nullptr;
+        return *this;
+      }
+
+      bool operator==(const Cursor &other) const { return this->processor_ == other.processor_; }
+
+      bool operator!=(const Cursor &other) const { return !(*this == other); }
+    };
+
+    [[nodiscard]] Cursor begin() const { return Cursor(this); }
+
+    [[nodiscard]] Cursor end() const { return Cursor(nullptr); }
+
+    static Objs_p compute(const BCode_p &bcode, const bool bulk = false, const bool batch = false,
+                          const uint8_t parallelism = 0, const bool planned = false) {
       ////////////////////////////////////////////////////////////////////
       if(const int custom_stack_size = Memory::get_stack_size(bcode, "config/stack_size", 0); custom_stack_size <= 0) {
-        const Obj_p objs = Processor(bcode).to_objs();
+        const Obj_p objs = Processor(bcode, bulk, batch, parallelism, planned).to_objs();
         return objs;
       } else {
         return Memory::singleton()->use_custom_stack(
             InstBuilder::build("process_custom_stack")
-                ->inst_f([](const Obj_p &bcode, const InstArgs &) { return Processor(bcode).to_objs(); })
+                ->inst_f([bulk, batch, parallelism, planned](const Obj_p &bcode, const InstArgs &) {
+                  return Processor(bcode, bulk, batch, parallelism, planned).to_objs();
+                })
                 ->create(),
             bcode, custom_stack_size);
       }
     }
 
-    static Objs_p compute(const string &bcode) { return Processor::compute(OBJ_PARSER(bcode)); }
+    static Objs_p compute(const string &bcode) { return Processor::compute(Processor::plan(bcode), false, false, 0, true); }
+
+    /// a parse without side effects or type checks (its value ids are written and typed values checked on creation)
+    /// the parse and plan caches only hold these
+    static bool cacheable(const Obj_p &obj) {
+      if(obj->vid || obj->is_type())
+        return false;
+      switch(obj->otype) {
+        case OType::INST:
+          return std::all_of(obj->inst_args()->rec_value()->begin(), obj->inst_args()->rec_value()->end(),
+                             [](const auto &kv) { return cacheable(kv.second); });
+        case OType::BCODE:
+          return std::all_of(obj->bcode_value()->begin(), obj->bcode_value()->end(), cacheable);
+        case OType::LST:
+          return obj->is_base_type() && std::all_of(obj->lst_value()->begin(), obj->lst_value()->end(), cacheable);
+        case OType::OBJS:
+          return std::all_of(obj->objs_value()->begin(), obj->objs_value()->end(), cacheable);
+        case OType::REC:
+          return obj->is_base_type() &&
+                 std::all_of(obj->rec_value()->begin(), obj->rec_value()->end(),
+                             [](const auto &kv) { return cacheable(kv.first) && cacheable(kv.second); });
+        default:
+          return obj->is_base_type();
+      }
+    }
+
+    /// parsed and rewritten source (until an inst, a type, or a rewrite toggle changes)
+    static LRUCache<string, Obj_p> *plans() {
+      static LRUCache<string, Obj_p> plans(FOS_PLAN_CACHE_SIZE);
+      return &plans;
+    }
+
+    /// the source parsed and rewritten as a processor would rewrite it (plans are shared and must not be mutated)
+    static Obj_p plan(const string &source) {
+      const auto version =
+          static_cast<long>(hash_combine(Compiler::inst_cache_epoch(), static_cast<size_t>(Rewriter::version().load())));
+      if(const std::optional<Obj_p> cached = Processor::plans()->get(source, version))
+        return cached.value();
+      Obj_p plan = OBJ_PARSER(source);
+      if(plan->is_code()) {
+        if(plan->is_inst())
+          plan = Obj::to_bcode({plan});
+        // a terminal profile() stays for the processor to strip (its insts are rewritten unfused)
+        if(const InstList_p insts = plan->bcode_value(); insts->size() > 1 && "profile" == insts->back()->inst_op()) {
+          InstList rewritten =
+              *Processor::rewriter(false).apply(Obj::to_bcode(InstList(insts->begin(), insts->end() - 1)))->bcode_value();
+          rewritten.push_back(insts->back());
+          plan = Obj::to_bcode(rewritten);
+        } else
+          plan = Processor::rewriter(true).apply(plan);
+      }
+      if(Processor::cacheable(plan))
+        Processor::plans()->put(source, plan, version);
+      return plan;
+    }
+
+    /// the rewrites applied to every submitted bcode
+    static const Rewriter &rewriter(const bool fuse) {
+      const auto rewrites = [](const bool f) {
+        List<Rewrite> rws = Rewriter::optimizations(f);
+        rws.push_back(Rewriter::by());
+        rws.push_back(Rewriter::explain());
+        return Rewriter(rws);
+      };
+      static const Rewriter FUSED = rewrites(true);
+      static const Rewriter UNFUSED = rewrites(false);
+      return fuse ? FUSED : UNFUSED;
+    }
 
     static void register_module() {
       BCODE_PROCESSOR = [](const BCode_p &bcode) -> Objs_p { return Processor::compute(bcode); };
@@ -191,10 +801,63 @@ namespace fhatos {
                                                         ->domain_range(OBJ_FURI, {0, 1}, OBJ_FURI, {0, 1})
                                                         ->inst_args(rec({{"code?str", Obj::to_bcode()}}))
                                                         ->inst_f([](const Obj_p &, const InstArgs &args) {
-                                                          Objs_p result = Processor::compute(
-                                                              OBJ_PARSER(args->arg("code")->str_value()));
+                                                          Objs_p result =
+                                                              Processor::compute(args->arg("code")->str_value());
                                                           return result;
                                                         })
+                                                        ->create()},
+                                                   {Obj::to_uri(ID(PROCESSOR_TID).add_component("inst_cache")),
+                                                    InstBuilder::build(ID(PROCESSOR_TID).add_component("inst_cache"))
+                                                        ->domain_range(OBJ_FURI, {0, 1}, REC_FURI, {1, 1})
+                                                        ->inst_f([](const Obj_p &, const InstArgs &) {
+                                                          return Compiler::inst_cache_stats();
+                                                        })
+                                                        ->create()},
+                                                   {Obj::to_uri(ID(PROCESSOR_TID).add_component("type_cache")),
+                                                    InstBuilder::build(ID(PROCESSOR_TID).add_component("type_cache"))
+                                                        ->domain_range(OBJ_FURI, {0, 1}, REC_FURI, {1, 1})
+                                                        ->inst_f([](const Obj_p &, const InstArgs &) {
+                                                          return Compiler::type_cache_stats();
+                                                        })
+                                                        ->create()},
+                                                   {Obj::to_uri(ID(PROCESSOR_TID).add_component("parallelism")),
+                                                    InstBuilder::build(ID(PROCESSOR_TID).add_component("parallelism"))
+                                                        ->domain_range(OBJ_FURI, {0, 1}, INT_FURI, {1, 1})
+                                                        ->inst_args(rec({{"cores?int", Obj::to_bcode()}}))
+                                                        ->inst_f([](const Obj_p &, const InstArgs &args) {
+                                                          if(const Obj_p cores = args->arg("cores");
+                                                             cores->is_int() && cores->int_value() > 0)
+                                                            PROCESSOR_PARALLELISM = static_cast<uint8_t>(
+                                                                std::min<FOS_INT_TYPE>(cores->int_value(), 255));
+                                                          return jnt(PROCESSOR_PARALLELISM.load());
+                                                        })
+                                                        ->create()},
+                                                   {Obj::to_uri(ID(PROCESSOR_TID).add_component("profile")),
+                                                    InstBuilder::build(ID(PROCESSOR_TID).add_component("profile"))
+                                                        ->domain_range(OBJ_FURI, {0, 1}, REC_FURI, {1, 1})
+                                                        ->inst_args(rec({{"rate?int", Obj::to_bcode()}}))
+                                                        ->inst_f([](const Obj_p &, const InstArgs &args) {
+                                                          // a new rate starts a new aggregation (0 stops sampling)
+                                                          if(const Obj_p rate = args->arg("rate");
+                                                             rate->is_int() && rate->int_value() >= 0) {
+                                                            PROFILE_SAMPLING = static_cast<uint32_t>(rate->int_value());
+                                                            Profiler::singleton()->reset();
+                                                          }
+                                                          return Profiler::singleton()->to_rec();
+                                                        })
+                                                        ->create()},
+                                                   {Obj::to_uri(ID(PROCESSOR_TID).add_component("rewrites")),
+                                                    InstBuilder::build(ID(PROCESSOR_TID).add_component("rewrites"))
+                                                        ->domain_range(OBJ_FURI, {0, 1}, REC_FURI, {1, 1})
+                                                        ->inst_args(rec({{"rewrite?uri", Obj::to_bcode()},
+                                                                         {"enabled?bool", Obj::to_bcode()}}))
+                                                        ->inst_f([](const Obj_p &, const InstArgs &args) {
+                                                          if(const Obj_p rewrite = args->arg("rewrite");
+                                                             rewrite->is_uri() && args->arg("enabled")->is_bool())
+                                                            Rewriter::enable(rewrite->uri_value(),
+                                                                             args->arg("enabled")->bool_value());
+                                                          return Rewriter::stats_rec();
+                                                        })
                                                         ->create()}});
                              })
                              ->create());
@@ -229,9 +892,11 @@ namespace fhatos {
             LOG_WRITE(TRACE, this->processor_, L("monad {} halting\n", this->toString()));
             this->halt();
           }
+        } else if(const bool sampled = Profiler::sample(); sampled || this->processor_->profiling_) {
+          this->profiled_loop(sampled);
         } else {
           // const Inst_p current_inst_resolved = TYPE_INST_RESOLVER(this->obj, this->inst);
-          const Inst_p current_inst_resolved = this->processor_->compiler_->resolve_inst(this->obj, this->inst);
+          const Inst_p current_inst_resolved = this->processor_->compiler()->resolve_inst(this->obj, this->inst);
           LOG_WRITE(TRACE, this->processor_,
                     L("monad {} applying to resolved inst {} !m=>!! {} [!m{}!!]\n", this->toString(),
                       this->inst->toString(), current_inst_resolved->toString(), "SIGNATURE HERE"));
@@ -239,6 +904,24 @@ namespace fhatos {
         }
       }
 
+      /// loop() measured into the processor's profile (when profiling) and the Profiler's samples (when sampled)
+      void profiled_loop(const bool sampled) const {
+        InstProfile step;
+        const long emitted = EMITTED;
+        const ProfileTimer timer;
+        const Inst_p current_inst_resolved = this->processor_->compiler()->resolve_inst(this->obj, this->inst);
+        step.resolve_ns = timer.elapsed_ns();
+        this->domain_loop(current_inst_resolved);
+        timer.stop(&step);
+        // a barrier monad's objs were counted in as they were gathered
+        step.in = this->obj->is_objs() ? 0 : this->bulk;
+        step.out = EMITTED - emitted;
+        if(this->processor_->profiling_)
+          this->processor_->profile(this->inst, step);
+        if(sampled)
+          Profiler::singleton()->record(current_inst_resolved, step);
+      }
+
       ///////////////////////////////////////////////////////////////////////////
 
       void domain_loop(const Inst_p &current_inst_resolved) const {
@@ -250,15 +933,21 @@ namespace fhatos {
             LOG_WRITE(TRACE, this->processor_,
                       L("barrier monad [size: {}] fetch for processing by {} [!m{}!m]\n",
                         this->obj->objs_value()->size(), current_inst_resolved->toString(), "SIGNATURE HERE"));
-            range_loop(current_inst_resolved->apply(this->obj), current_inst_resolved);
+            range_loop(this->processor_->apply_barrier(current_inst_resolved, this->obj), current_inst_resolved);
           } else {
-            this->processor_->barriers_->front()->obj->add_obj(this->obj);
+            this->processor_->gather(current_inst_resolved, this->obj, this->bulk);
             LOG_WRITE(TRACE, this->processor_,
                       L("monad {} stored in barrier [size: {}] [!m{}!m]\n", this->toString(),
                         this->processor_->barriers_->front()->obj->objs_value()->size(), "SIGNATURE HERE"));
           }
         } else {
           //  this->obj->CHECK_OBJ_TO_INST_SIGNATURE(current_inst_resolved, true);
+          if(Processor::is_limit(current_inst_resolved)) {
+            if(const long admitted = this->processor_->admit(this->inst, this->bulk); admitted > 0)
+              this->processor_->M(this->obj, this->inst, admitted)->range_loop(this->obj, current_inst_resolved);
+            return;
+          }
+          DOMAIN_CHECKED = this->processor_->proven(this->inst, this->obj, current_inst_resolved);
           range_loop(current_inst_resolved->apply(this->obj), current_inst_resolved);
         }
       }
@@ -280,31 +969,27 @@ namespace fhatos {
           LOG_WRITE(TRACE, this->processor_,
                     L("monad {} scattering [{}]\n", this->toString().c_str(), "SIGNATURE HERE"));
           for(const Obj_p &o: *next_obj->objs_value()) {
-            const Monad_p m = this->processor_->M(o, next_inst);
+            const Monad_p m = this->processor_->M(o, next_inst, this->bulk);
             LOG_WRITE(TRACE, this->processor_,
                       L("monad %s !r==!gmigrating!r==>!! %s\n", this->toString(), m->toString()));
-            this->processor_->running_->push_back(m);
+            this->processor_->emit(m);
           }
         } else {
-          const Monad_p m = this->processor_->M(next_obj, next_inst);
+          const Monad_p m = this->processor_->M(next_obj, next_inst, this->bulk);
           LOG_WRITE(TRACE, this->processor_,
                     L("monad {} !r==!gmigrating!r==>!! {}\n", this->toString(), m->toString()));
-          this->processor_->running_->push_back(m);
+          this->processor_->emit(m);
         }
       }
 
       bool operator==(const Monad &other) const { return this->equals(other); }
 
       [[nodiscard]] bool equals(const Monad &other) const {
-        return this->inst->equals(*other.inst) && this->obj->equals(*other.obj);
+        return (this->inst == other.inst || this->inst->equals(*other.inst)) &&
+               Obj::objp_equal_to()(this->obj, other.obj);
       }
 
-      void halt() const {
-        this->processor_->halted_->push_back(this->obj);
-        /*for(int i = 0; i < this->bulk_; i++) {
-          this->processor_->halted_->push_back(std::move(this->obj_->clone()));
-        }*/
-      }
+      void halt() const { this->processor_->halt(this->obj, this->bulk); }
 
       bool operator<(const Monad &rhs) const {
         return this->obj->toString() < rhs.obj->toString() || this->inst->toString() < rhs.inst->toString();
@@ -322,62 +1007,126 @@ namespace fhatos {
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 
-    struct TransparentCompare {
-      using is_transparent = void;
-
-      template<typename T, typename U>
-      bool operator()(T &&lhs, U &&rhs) const {
-        return *std::forward<T>(lhs) < *std::forward<U>(rhs);
-      }
+    struct monadp_hash {
+      size_t operator()(const Monad_p &monad) const { return monad->obj->hash(); }
     };
 
-    /* struct monadp_equal_to : std::binary_function<Monad_p &, Monad_p &, bool> {
-       bool operator()(const Monad_p &a, const Monad_p &b) const { return a->equals(*b); }
-     };*/
+    struct monadp_equal_to {
+      bool operator()(const Monad_p &a, const Monad_p &b) const { return a == b || a->equals(*b); }
+    };
 
+    /// a fifo of monads where (when bulking) a pushed monad equal to a queued monad is merged into its bulk
     class MonadSet {
+    protected:
+      const bool bulk_;
+      const unique_ptr<Deque<Monad_p>> queue_ = make_unique<Deque<Monad_p>>();
+      const unique_ptr<std::unordered_set<Monad_p, monadp_hash, monadp_equal_to>> index_ =
+          make_unique<std::unordered_set<Monad_p, monadp_hash, monadp_equal_to>>();
+
     public:
-      const unique_ptr<Set<Monad_p, TransparentCompare>> internal = make_unique<Set<Monad_p, TransparentCompare>>();
+      explicit MonadSet(const bool bulk = true) : bulk_(bulk) {}
 
-      [[nodiscard]] bool empty() const { return this->internal->empty(); }
+      [[nodiscard]] bool empty() const { return this->queue_->empty(); }
 
-      [[nodiscard]] long bulk_of(const Pair_p<Obj_p, Inst_p> &monad) const {
-        if(const auto it = this->internal->find(make_shared<Monad>(nullptr, monad->first, monad->second));
-           it != this->internal->end()) {
+      [[nodiscard]] long bulk_of(const Monad_p &monad) const {
+        if(const auto it = this->index_->find(monad); it != this->index_->end())
           return (*it)->bulk;
-        }
         return 0l;
       }
 
-      [[nodiscard]] unsigned long size() const { return this->internal->size(); }
+      [[nodiscard]] unsigned long size() const { return this->queue_->size(); }
 
       [[nodiscard]] unsigned long bulk_size() const {
         unsigned long bulk_total = 0;
-        for(const auto &o: *this->internal) {
-          bulk_total += o->bulk;
+        for(const auto &m: *this->queue_) {
+          bulk_total += m->bulk;
         }
         return bulk_total;
       }
 
-      [[nodiscard]] Monad_p next() const { return std::move(this->internal->extract(this->internal->begin()).value()); }
+      [[nodiscard]] Monad_p next() const {
+        const Monad_p monad = this->queue_->front();
+        this->pop_front();
+        return monad;
+      }
+
+      [[nodiscard]] Monad_p front() const { return this->queue_->front(); }
 
-      [[nodiscard]] Monad_p front() const { return *this->internal->begin(); }
+      /// remove (in fifo order) every queued monad that satisfies the predicate
+      [[nodiscard]] List<Monad_p> extract_if(const Predicate<const Monad_p &> &predicate) const {
+        List<Monad_p> extracted;
+        auto keep = this->queue_->begin();
+        for(auto it = this->queue_->begin(); it != this->queue_->end(); ++it) {
+          if(predicate(*it)) {
+            extracted.push_back(*it);
+            if(this->bulk_)
+              this->index_->erase(*it);
+          } else
+            *keep++ = *it;
+        }
+        this->queue_->erase(keep, this->queue_->end());
+        return extracted;
+      }
+
+      /// queue the monads (in order) ahead of all queued monads
+      void push_front(const List<Monad_p> &monads) const {
+        for(auto it = monads.rbegin(); it != monads.rend(); ++it) {
+          if(this->bulk_) {
+            if(const auto found = this->index_->find(*it); found != this->index_->end()) {
+              (*found)->bulk = (*found)->bulk + (*it)->bulk;
+              continue;
+            }
+            this->index_->insert(*it);
+          }
+          this->queue_->push_front(*it);
+        }
+      }
+
+      void clear() const {
+        this->queue_->clear();
+        this->index_->clear();
+      }
+
+      /// remove the newest monad (idle workers steal from the back)
+      [[nodiscard]] Monad_p pop_back() const {
+        const Monad_p monad = this->queue_->back();
+        if(this->bulk_)
+          this->index_->erase(monad);
+        this->queue_->pop_back();
+        return monad;
+      }
 
       void pop_front() const {
-        this->internal->erase(this->internal->begin());
-        // auto node =
-        //  return move(node.value());
+        if(this->bulk_)
+          this->index_->erase(this->queue_->front());
+        this->queue_->pop_front();
       }
 
-      void push_back(const Monad_p &monad) const {
-        if(const auto it = this->internal->find(monad); it != this->internal->end()) {
-          // LOG(INFO, "FOUND: %s ==  %s\n", (*it)->toString().c_str(), monad->toString().c_str());
-          (*it)->bulk = (*it)->bulk + monad->bulk;
-        } else
-          this->internal->insert(monad);
+      /// false if the monad was merged into a queued monad's bulk
+      bool push_back(const Monad_p &monad) const {
+        if(this->bulk_) {
+          if(const auto it = this->index_->find(monad); it != this->index_->end()) {
+            (*it)->bulk = (*it)->bulk + monad->bulk;
+            return false;
+          }
+          this->index_->insert(monad);
+        }
+        this->queue_->push_back(monad);
+        return true;
       }
     };
 
+    /// a work-stealing worker: its own running monads and compiler (compilers are not thread safe)
+    struct Worker {
+      MonadSet running;
+      uptr<Compiler> compiler = make_unique<Compiler>();
+      Combiner_p combiner;
+      Map<const Obj *, InstProfile> profiles;
+      Mutex mutex;
+
+      explicit Worker(const bool bulk) : running(bulk) {}
+    };
+
     ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   };
 
@@ -0,0 +1,145 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#pragma once
+#ifndef fhatos_profiler_hpp
+#define fhatos_profiler_hpp
+
+#include "../../fhatos.hpp"
+#include "../../model/fos/sys/scheduler/thread/mutex.hpp"
+#include "../obj.hpp"
+#include <chrono>
+
+namespace fhatos {
+  /// one in every PROFILE_SAMPLING monad steps (per thread) is measured and aggregated by the Profiler (0 is off)
+  inline atomic<uint32_t> PROFILE_SAMPLING{1024};
+
+  /// the runtime numbers of an inst (a sum of monad steps at the inst)
+  struct InstProfile {
+    long steps = 0;
+    long in = 0;
+    long out = 0;
+    uint64_t wall_ns = 0;
+    uint64_t resolve_ns = 0;
+    uint64_t type_check_ns = 0;
+    uint64_t type_checks = 0;
+    uint64_t type_checks_elided = 0;
+    uint64_t frame_pushes = 0;
+    uint64_t allocations = 0;
+
+    void merge(const InstProfile &other) {
+      this->steps += other.steps;
+      this->in += other.in;
+      this->out += other.out;
+      this->wall_ns += other.wall_ns;
+      this->resolve_ns += other.resolve_ns;
+      this->type_check_ns += other.type_check_ns;
+      this->type_checks += other.type_checks;
+      this->type_checks_elided += other.type_checks_elided;
+      this->frame_pushes += other.frame_pushes;
+      this->allocations += other.allocations;
+    }
+
+    [[nodiscard]] Rec_p to_rec() const {
+      const auto ms = [](const uint64_t ns) { return Obj::to_real(static_cast<FOS_REAL_TYPE>(ns / 1000000.0)); };
+      return Obj::to_rec({{"steps", jnt(this->steps)},
+                          {"in", jnt(this->in)},
+                          {"out", jnt(this->out)},
+                          {"wall_ms", ms(this->wall_ns)},
+                          {"resolve_ms", ms(this->resolve_ns)},
+                          {"type_check_ms", ms(this->type_check_ns)},
+                          {"type_checks", jnt(static_cast<FOS_INT_TYPE>(this->type_checks))},
+                          {"type_checks_elided", jnt(static_cast<FOS_INT_TYPE>(this->type_checks_elided))},
+                          {"frame_pushes", jnt(static_cast<FOS_INT_TYPE>(this->frame_pushes))},
+                          {"allocations", jnt(static_cast<FOS_INT_TYPE>(this->allocations))}});
+    }
+  };
+
+  /// measures a monad step from construction to stop() using the thread's ProfileCounters
+  /// (type checks are timed until the timer is destroyed)
+  class ProfileTimer {
+    using Clock = std::chrono::steady_clock;
+    const ProfileCounters before_;
+    const Clock::time_point start_;
+    const bool timing_;
+
+    static uint64_t ns(const Clock::duration &duration) {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    }
+
+  public:
+    ProfileTimer() : before_(PROFILE_COUNTERS), start_(Clock::now()), timing_(PROFILE_COUNTERS.timing) {
+      PROFILE_COUNTERS.timing = true;
+    }
+
+    [[nodiscard]] uint64_t elapsed_ns() const { return ns(Clock::now() - this->start_); }
+
+    void stop(InstProfile *profile) const {
+      profile->steps++;
+      profile->wall_ns += this->elapsed_ns();
+      profile->type_check_ns += PROFILE_COUNTERS.type_check_ns - this->before_.type_check_ns;
+      profile->type_checks += PROFILE_COUNTERS.type_checks - this->before_.type_checks;
+      profile->type_checks_elided += PROFILE_COUNTERS.type_checks_elided - this->before_.type_checks_elided;
+      profile->frame_pushes += PROFILE_COUNTERS.frame_pushes - this->before_.frame_pushes;
+      profile->allocations += PROFILE_COUNTERS.allocations - this->before_.allocations;
+    }
+
+    ~ProfileTimer() { PROFILE_COUNTERS.timing = this->timing_; }
+  };
+
+  /// the sampled inst profiles of every processor keyed by resolved inst (published at /sys/vm/profile)
+  class Profiler {
+    Mutex mutex_;
+    Map<string, InstProfile> insts_;
+
+  public:
+    static Profiler *singleton() {
+      static Profiler profiler;
+      return &profiler;
+    }
+
+    /// whether the current thread's next monad step is sampled
+    static bool sample() {
+      static thread_local uint32_t tick = 0;
+      const uint32_t rate = PROFILE_SAMPLING.load(std::memory_order_relaxed);
+      return rate > 0 && 0 == ++tick % rate;
+    }
+
+    void record(const Inst_p &resolved, const InstProfile &sample) {
+      const string key = resolved->tid->toString();
+      auto lock = std::lock_guard<Mutex>(this->mutex_);
+      this->insts_[key].merge(sample);
+    }
+
+    void reset() {
+      auto lock = std::lock_guard<Mutex>(this->mutex_);
+      this->insts_.clear();
+    }
+
+    [[nodiscard]] Rec_p to_rec() {
+      const Rec_p insts = Obj::to_rec();
+      {
+        auto lock = std::lock_guard<Mutex>(this->mutex_);
+        for(const auto &[key, profile]: this->insts_) {
+          insts->insert_into_position(vri(key), profile.to_rec());
+        }
+      }
+      return Obj::to_rec({{"rate", jnt(PROFILE_SAMPLING.load())}, {"insts", insts}});
+    }
+  };
+} // namespace fhatos
+#endif
@@ -53,6 +53,7 @@ int main(const int argc, char **argv) {
     ansi->printf(HELP, "ansi", "!gbool!!?!ycolorize!!");
     ansi->printf(HELP, "log", "!guri!!?{!gINFO!!,!yWARN!!,!rERROR!!,!mDEBUG!!,!cTRACE!!,!bALL!!,!cNONE!!}");
     ansi->printf(HELP, "fs:mount", "!guri!!?!ylocal_dir_path!!");
+    ansi->printf(HELP, "heap:share", "!gbool!!?!ycopy-on-write kernel heaps!!");
     ansi->printf(HELP, "mqtt:broker", "!guri!!?!yserver uri!!");
     ansi->printf(HELP, "mqtt:client", "!guri!!?!yclient_name!!");
     ansi->printf(HELP, "console:nest", "!gint!!?!ydepth!!");
@@ -81,7 +81,7 @@ namespace fhatos {
       /// pre-read
       const fURI furi_no_query = furi.no_query();
       const Objs_p subs = Obj::to_objs();
-      for(const Subscription_p &sub: *this->post_->subscriptions_) {
+      for(const Subscription_p &sub: this->post_->subscriptions_->match(furi_no_query)) {
         if(furi_no_query.matches(*sub->pattern())) {
           subs->add_obj(sub);
         }
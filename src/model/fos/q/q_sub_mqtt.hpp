@@ -74,7 +74,7 @@ namespace fhatos {
         LOG_WRITE(TRACE, this,L("!ypre-wrote!! !b{}!! -> {}\n", furi_no_query.toString(), obj->toString()));
       } else if(retain && POSITION::Q_LESS == pos) {
         // publish
-        for(const Subscription_p &sub: *this->mqtt->subscriptions_) {
+        for(const Subscription_p &sub: this->mqtt->subscriptions_->match(furi_no_query)) {
           if(furi_no_query.bimatches(*sub->pattern())) {
             const Message_p msg = Message::create(id_p(furi_no_query), obj, retain);
             LOG_WRITE(DEBUG, this,L("!ysending mail!! !b{}!! -> {}\n", msg->toString(), sub->toString()));
@@ -88,7 +88,7 @@ namespace fhatos {
       /// pre-read
       const fURI furi_no_query = furi.no_query();
       Objs_p subs = Obj::to_objs();
-      for(const Subscription_p &sub: *this->mqtt->subscriptions_) {
+      for(const Subscription_p &sub: this->mqtt->subscriptions_->match(furi_no_query)) {
         if(furi_no_query.bimatches(*sub->pattern())) {
           subs->add_obj(sub);
         }
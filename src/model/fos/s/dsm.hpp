@@ -44,6 +44,8 @@ namespace fhatos {
         make_unique<MutexMap<const ID, Obj_p, std::less<>, std::allocator<std::pair<const ID, Obj_p>>>>();
     size_t cache_size_ = 100;
     bool async = false;
+    /// the replication payload encoding (config/codec: text or binary)
+    Codec codec_ = Codec::TEXT;
     ptr<MqttClient> mqtt{};
 
     [[nodiscard]] Subscription_p generate_sync_subscription(const Pattern &pattern) const {
@@ -67,6 +69,7 @@ namespace fhatos {
         Structure(pattern, id_p(DSM_TID), value_id, config), mqtt{nullptr} {
       this->cache_size_ = config->rec_get("cache_size")->or_else_(100);
       this->async = this->rec_get("config/async")->or_else_(false);
+      this->codec_ = ObjCodec::codec(config->rec_get("codec"));
     }
 
     static Structure_p create(const Pattern &pattern, const ID_p &value_id = nullptr,
@@ -88,10 +91,11 @@ namespace fhatos {
 
     void setup() override {
       const auto q_sub = static_cast<const QSub *>(this->q_procs_->rec_get("sub").get());
-      this->mqtt = MqttClient::get_or_create(this->get<fURI>("config/broker"), this->get<fURI>("config/client"));
+      this->mqtt = MqttClient::get_or_create(this->get<fURI>("config/broker"), this->get<fURI>("config/client"),
+                                             this->codec_);
       const_cast<QSub *>(q_sub)->set_post<MqttClient>([this]() {
         return MqttClient::get_or_create(this->obj_get("config/broker")->uri_value(),
-                                         this->obj_get("config/client")->uri_value());
+                                         this->obj_get("config/client")->uri_value(), this->codec_);
       });
       if(this->cache_size_ > 0) {
         this->mqtt->on_connect = [this]() {
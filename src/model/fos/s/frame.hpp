@@ -15,79 +15,110 @@ FhatOS: A Distributed Operating System
   You should have received a copy of the GNU Affero General Public License
   along with this program.  If not, see <http://www.gnu.org/licenses/>.
  ******************************************************************************/
-
+#pragma once
 #ifndef fhatos_frame_hpp
 #define fhatos_frame_hpp
 
 #include "../../../fhatos.hpp"
 #include "../../../furi.hpp"
-#include "../sys/router/structure.hpp"
-
-#define FRAME_TID  "/sys/router/frame"
+#include "../../../lang/obj.hpp"
+#include "../../../util/string_helper.hpp"
 
 namespace fhatos {
-
-  template<typename ALLOCATOR = std::allocator<std::pair<const ID_p, Obj_p>>>
-  class Frame final : public Structure {
+  /// a flat stack of frame bindings (one per thread)
+  /// frames are key/obj slot ranges in a single vector (no per-frame structure is allocated)
+  class FrameStack {
   protected:
-    Rec_p data_;
+    struct Binding {
+      Obj_p key; // the frame data key (uri keys have their query removed)
+      Obj_p value;
+    };
 
-  public:
-    ptr<Frame<>> previous_{};
+    struct Frame {
+      size_t begin; // index of the frame's first binding
+      Pattern_p pattern; // nullptr for #
+    };
 
-    explicit Frame(const Pattern &pattern,
-                   const ptr<Frame> &previous = nullptr,
-                   const Rec_p &frame_data = Obj::to_rec()) :
-      Structure(pattern, id_p(FRAME_TID)), //id_p(pattern.retract())),
-      data_{frame_data->rec_no_query()}, previous_{previous} {
-    }
+    std::vector<Binding> bindings_;
+    std::vector<Frame> frames_;
 
+    [[nodiscard]] size_t end(const size_t frame) const {
+      return frame + 1 < this->frames_.size() ? this->frames_.at(frame + 1).begin : this->bindings_.size();
+    }
 
-    [[nodiscard]] size_t depth() const {
-      return this->previous_ ? this->previous_->depth() + 1 : 1;
+    /// unnamed args are accessed by index (e.g. *0)
+    static bool is_index(const fURI &furi) {
+      return 1 == furi.path_length() && isdigit(furi.segment(0)[0]) && StringHelper::is_integer(furi.toString());
     }
 
-    [[nodiscard]] Rec_p full_frame() const {
-      const Rec_p all_frames = this->previous_ ? this->previous_->full_frame() : Obj::to_rec();
-      for(const auto &[key,value]: *this->data_->rec_value()) {
-        all_frames->rec_value()->insert({key, value});
-      }
-      return all_frames;
+    static bool key_equals(const Obj_p &key, const fURI &furi) {
+      if(!key->is_uri())
+        return false;
+      const fURI *key_furi = key->uri_value_ptr();
+      return key_furi && key_furi->equals(furi);
     }
 
-    ////////////////////////////////////////////////////////////////////////////////////////////
-
-    Obj_p read(const fURI &furi) override {
-      const fURI furi_no_query = furi.no_query();
-      if(this->previous_ && StringHelper::is_integer(furi_no_query.toString())) { // unnamed args accessed by index
-        const int index = stoi(furi_no_query.toString());
-        if(index >= this->previous_->data_->rec_value()->size())
-          return Obj::to_noobj();
-        auto itty = this->previous_->data_->rec_value()->begin();
-        std::advance(itty, index);
-        return itty->second;
+  public:
+    FrameStack() = default;
+
+    void push(const Pattern &pattern, const Rec_p &frame_data) {
+      ++PROFILE_COUNTERS.frame_pushes;
+      const bool any = 1 == pattern.path_length() && 0 == strcmp(pattern.segment(0), "#") && !pattern.has_scheme() &&
+                       !pattern.has_host();
+      this->frames_.push_back({this->bindings_.size(), any ? nullptr : make_shared<Pattern>(pattern)});
+      for(const auto &[k, v]: *frame_data->rec_value()) {
+        if(k->is_uri() && k->uri_value_ptr()->has_query())
+          this->bindings_.push_back({Obj::to_uri(k->uri_value_ptr()->no_query()), v});
+        else
+          this->bindings_.push_back({k, v});
       }
-      return !furi_no_query.matches(*this->pattern) || this->data_->rec_value()->count(vri(furi_no_query)) == 0
-               ? (nullptr == this->previous_ ? nullptr : this->previous_->read(furi_no_query))
-               : this->data_->rec_value()->at(vri(furi_no_query));
     }
 
-    void write(const fURI &furi, const Obj_p &obj, const bool retain) override {
-      const fURI furi_no_query = furi.no_query();
-      if(this->data_->rec_value()->count(vri(furi_no_query)))
-        throw fError("frame structures objs are read-only");
-      if(this->previous_)
-        this->previous_->write(furi_no_query, obj, retain);
-      else
-        ROUTER_WRITE(furi, obj, retain);
+    void pop() {
+      if(this->frames_.empty())
+        throw fError("there are no more frames on the stack");
+      this->bindings_.resize(this->frames_.back().begin);
+      this->frames_.pop_back();
     }
 
-    void write_raw_pairs(const ID &, const Obj_p &, bool retain) override {
-      throw fError("frame::write_raw_pairs is unreachable code");
+    [[nodiscard]] bool empty() const { return this->frames_.empty(); }
+
+    [[nodiscard]] size_t depth() const { return this->frames_.size(); }
+
+    /// the obj bound to the furi (nullptr if unbound)
+    [[nodiscard]] Obj_p read(const fURI &furi) const {
+      if(this->frames_.empty())
+        return nullptr;
+      const Option<fURI> no_query = furi.has_query() ? Option<fURI>(furi.no_query()) : Option<fURI>();
+      const fURI &key = no_query.has_value() ? no_query.value() : furi;
+      size_t frame = this->frames_.size() - 1;
+      if(frame > 0 && is_index(key)) {
+        // positional args are those of the previous frame
+        const size_t index = stoi(key.toString());
+        const size_t begin = this->frames_.at(frame - 1).begin;
+        return index >= this->end(frame - 1) - begin ? Obj::to_noobj() : this->bindings_.at(begin + index).value;
+      }
+      while(true) {
+        const Frame &f = this->frames_.at(frame);
+        if(!f.pattern || key.matches(*f.pattern)) {
+          for(size_t i = f.begin; i < this->end(frame); i++) {
+            if(key_equals(this->bindings_.at(i).key, key))
+              return this->bindings_.at(i).value;
+          }
+        }
+        if(0 == frame)
+          return nullptr;
+        frame--;
+      }
     }
 
-    IdObjPairs read_raw_pairs(const fURI &) override {
-      throw fError("frame::read_raw_pairs is unreachable code");
+    /// all frame bindings as a rec (earlier frames take precedence)
+    [[nodiscard]] Rec_p full_frame() const {
+      const Rec_p all_frames = Obj::to_rec();
+      for(const Binding &binding: this->bindings_) {
+        all_frames->rec_value()->insert({binding.key, binding.value});
+      }
+      return all_frames;
     }
   };
 } // namespace fhatos
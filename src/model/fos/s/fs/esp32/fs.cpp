@@ -74,7 +74,8 @@ namespace fhatos {
   }
 
   FS::FS(const Pattern &pattern, const ID_p &value_id, const Rec_p &config) :
-      Structure(pattern, id_p(FS_TID), value_id, config), root(config->rec_get("root")->uri_value()) {
+      Structure(pattern, id_p(FS_TID), value_id, config), root(config->rec_get("root")->uri_value()),
+      codec_(ObjCodec::codec(config->rec_get("codec"))) {
     if(vid && this->root.equals(ID("."))) {
       this->root = ID("data").extend(string("/").append(vid->name()));
       this->obj_set("config", vri(this->root));
@@ -178,7 +179,7 @@ namespace fhatos {
     if(!FOS_FS.exists(dir_name))
       FOS_FS.mkdir(dir_name);
     fs::File file = FOS_FS.open(file_name, retain ? "w" : "a", true);
-    const BObj_p bobj = obj->serialize();
+    const BObj_p bobj = ObjCodec::encode(obj, this->codec_);
     for(unsigned int i = 0; i < bobj->first; i++) {
       file.write(bobj->second[i]);
     }
@@ -196,7 +197,7 @@ namespace fhatos {
           const String contents = file.readString();
           file.close();
           const BObj_p bobj = make_shared<BObj>(contents.length(), (fbyte *) contents.c_str());
-          pairs.emplace_back(Pair<ID, Obj_p>(path, Obj::deserialize(bobj)));
+          pairs.emplace_back(Pair<ID, Obj_p>(path, ObjCodec::decode(bobj)));
         }
       } else {
         IdObjPairs new_pairs = read_raw_pairs_dir(fs, match, file);
@@ -23,6 +23,7 @@ FhatOS: A Distributed Operating System
 #include "../../../../fhatos.hpp"
 #include "../../sys/router/router.hpp"
 #include "../../sys/router/structure.hpp"
+#include "../../../../util/obj_codec.hpp"
 
 #define FS_TID "/fos/s/fs"
 
@@ -32,6 +33,8 @@ namespace fhatos {
 
   protected:
     ID root;
+    /// the file encoding of written objs (config/codec: text or binary)
+    Codec codec_;
 
     void write_raw_pairs(const ID &id, const Obj_p &obj, bool retain) override;
 
@@ -33,7 +33,8 @@ namespace fhatos {
   }
 
   FS::FS(const Pattern &span, const ID_p &vid, const Rec_p &config) :
-      Structure(span, id_p(FS_TID), vid, config), root(config->rec_get("root")->uri_value()) {
+      Structure(span, id_p(FS_TID), vid, config), root(config->rec_get("root")->uri_value()),
+      codec_(ObjCodec::codec(config->rec_get("codec"))) {
     if(vid && this->root.equals(ID("."))) {
       this->root = ID("data").extend(string("/").append(vid->name()));
       this->obj_set("config", vri(this->root));
@@ -94,11 +95,11 @@ namespace fhatos {
       if(id.is_node()) {
         if(const fs::path parent_path = file_path.parent_path(); !fs::exists(parent_path))
           fs::create_directories(parent_path);
-        const BObj_p bobj = obj->serialize();
-        auto outfile = std::ofstream(file_path, retain ? ios::trunc : ios::app);
+        const BObj_p bobj = ObjCodec::encode(obj, this->codec_);
+        auto outfile = std::ofstream(file_path, ios::binary | (retain ? ios::trunc : ios::app));
         if(!outfile.is_open())
           LOG_WRITE(WARN, this, L("unable to write to !b%s!! via !b%s!!\n", id.toString().c_str(), file_path.c_str()));
-        outfile << bobj->second;
+        outfile.write(reinterpret_cast<const char *>(bobj->second), bobj->first);
         outfile.flush();
         outfile.close();
       } else {
@@ -114,12 +115,12 @@ namespace fhatos {
     // LOG(INFO, "matching %s with %s via %s\n", match->toString().c_str(), fos_path.toString().c_str(),
     // fs_path.c_str());
     if(fos_path.is_node() && fs::is_regular_file(fs_path) && fos_path.matches(match)) {
-      auto infile = std::ifstream(fs_path, ios::in);
+      auto infile = std::ifstream(fs_path, ios::in | ios::binary);
       if(!infile.is_open())
         throw fError("unable to read from !b%s!! via !b%s!!", fos_path.toString().c_str(), fs_path.c_str());
       const auto content = string((std::istreambuf_iterator<char>(infile)), std::istreambuf_iterator<char>());
       infile.close();
-      const Obj_p obj = Obj::deserialize(make_shared<BObj>(content.length(), (fbyte *) content.c_str()));
+      const Obj_p obj = ObjCodec::decode(make_shared<BObj>(content.length(), (fbyte *) content.c_str()));
       pairs->push_back(Pair<ID, Obj_p>(fos_path, static_cast<Obj_p>(obj)));
     } else if(fs::is_directory(fs_path)) {
       for(const auto &p: fs::directory_iterator(fs_path)) {
@@ -23,6 +23,7 @@
 #include <shared_mutex>
 #include "../../../fhatos.hpp"
 #include "../../../lang/obj.hpp"
+#include "../../../util/segment_trie.hpp"
 #include "../sys/router/router.hpp"
 #include "../sys/router/structure.hpp"
 #include "../sys/scheduler/thread/mutex.hpp"
@@ -43,11 +44,17 @@ namespace fhatos {
   protected:
     const unique_ptr<Map<const ID, Obj_p, furi_less, ALLOCATOR>> data_ =
         make_unique<Map<const ID, Obj_p, furi_less, ALLOCATOR>>();
+    const unique_ptr<SegmentTrie<Obj_p>> trie_ = make_unique<SegmentTrie<Obj_p>>();
     Mutex map_mutex;
+    /// share (copy-on-write) or clone the stored objs on read (config/share)
+    const bool share_;
+    /// segment trie (default) or toString-ordered map storage (config/backend=>map)
+    const bool trie_backend_;
 
   public:
     explicit Heap(const Pattern &span, const ID_p &vid = nullptr, const Rec_p &config = Obj::to_rec()) :
-        Structure(span, id_p(HEAP_TID), vid, config) {}
+        Structure(span, id_p(HEAP_TID), vid, config), share_(config->rec_get("share")->or_else_(false)),
+        trie_backend_(config->rec_get("backend")->or_else(vri("trie"))->uri_value().toString() != "map") {}
 
     static Structure_p create(const Pattern &span, const ID_p &vid = nullptr,
                               const Rec_p &config = Obj::to_rec()) {
@@ -60,18 +67,34 @@ namespace fhatos {
 
     void stop() override {
       Structure::stop();
+      auto lock = std::lock_guard<Mutex>(this->map_mutex);
       this->data_->clear();
+      this->trie_->clear();
     }
 
   protected:
+    [[nodiscard]] bool shares_objs() const override { return this->share_; }
+
+    /// the obj as stored (shared heaps freeze polys on write and hand out the frozen obj on read)
+    [[nodiscard]] Obj_p store(const Obj_p &obj) const {
+      return this->share_ && !obj->is_poly() && !obj->is_code() && !obj->is_objs() ? obj : obj->clone();
+    }
+
+    [[nodiscard]] Obj_p load(const Obj_p &obj) const { return this->share_ ? obj : obj->clone(); }
+
     void write_raw_pairs(const ID &id, const Obj_p &obj, const bool retain) override {
       if(retain) {
         auto lock = std::lock_guard<Mutex>(this->map_mutex);
-        if(obj->is_noobj()) {
+        if(this->trie_backend_) {
+          if(obj->is_noobj())
+            this->trie_->erase(id);
+          else
+            this->trie_->insert_or_assign(id, this->store(obj));
+        } else if(obj->is_noobj()) {
           if(this->data_->count(id))
             this->data_->erase(id);
         } else {
-          this->data_->insert_or_assign(ID(id), obj->clone()); // clone?
+          this->data_->insert_or_assign(ID(id), this->store(obj));
         }
       }
     }
@@ -79,13 +102,23 @@ namespace fhatos {
     IdObjPairs read_raw_pairs(const fURI &match) override {
       auto list = IdObjPairs();
       auto lock = std::shared_lock<Mutex>(this->map_mutex);
-      if(!match.is_pattern()) {
+      if(this->trie_backend_) {
+        if(!match.is_pattern()) {
+          if(const Obj_p *obj = this->trie_->get(match))
+            list.push_back(std::make_pair<const ID, Obj_p>(ID(match), this->load(*obj)));
+        } else {
+          this->trie_->match(match, [this, &list](const ID &id, const Obj_p &obj) {
+            list.push_back(std::make_pair<const ID, Obj_p>(ID(id), this->load(obj)));
+            return true;
+          });
+        }
+      } else if(!match.is_pattern()) {
         if(this->data_->count(match))
-          list.push_back(std::make_pair<const ID, Obj_p>(ID(match), this->data_->at(match)->clone()));
+          list.push_back(std::make_pair<const ID, Obj_p>(ID(match), this->load(this->data_->at(match))));
       } else {
         for(const auto &[id, obj]: *this->data_) {
           if(id.matches(match)) {
-            list.push_back(std::make_pair<const ID, Obj_p>(ID(id), obj->clone())); // TODO: clone?
+            list.push_back(std::make_pair<const ID, Obj_p>(ID(id), this->load(obj)));
           }
         }
       }
@@ -94,6 +127,8 @@ namespace fhatos {
 
     bool has(const fURI &furi) override {
       auto lock = std::shared_lock<Mutex>(this->map_mutex);
+      if(this->trie_backend_)
+        return this->trie_->exists(furi);
       if(!furi.is_pattern() && this->data_->count(furi))
         return true;
       for(const auto &[id, obj]: *this->data_) {
@@ -23,7 +23,7 @@
 
 namespace fhatos {
 
-  inline thread_local ptr<Frame<>> THREAD_FRAME_STACK = nullptr;
+  inline thread_local FrameStack THREAD_FRAME_STACK;
 
   ptr<Router> &Router::singleton(const ID &vid) {
     static auto router = std::make_shared<Router>(vid);
@@ -36,13 +36,14 @@ namespace fhatos {
     return router;
   }
 
-  ptr<Frame<>> Router::get_frame() { return THREAD_FRAME_STACK; }
+  FrameStack &Router::get_frame() { return THREAD_FRAME_STACK; }
 
   Router::Router(const ID &id) :
       Rec(rmap({{"structure", to_lst()}}),
           // stop and attach
           OType::REC, REC_FURI, id_p(id)),
-      structures_(make_shared<MutexDeque<Structure_p>>()) {
+      structures_(make_shared<MutexDeque<Structure_p>>()),
+      structure_index_(make_shared<PatternTrie<Pair<uint64_t, Structure_p>>>()) {
     load_logger();
     ////////////////////////////////////////////////////////////////////////////////////
     ROUTER_ID = id_p(id);
@@ -51,7 +52,7 @@ namespace fhatos {
       fhatos::Router::push_frame(pattern, frame_data);
     };
     ROUTER_POP_FRAME = [this] { this->pop_frame(); };
-    ROUTER_GET_FRAME_DATA = [this] { return this->get_frame()->full_frame(); };
+    ROUTER_GET_FRAME_DATA = [this] { return this->get_frame().full_frame(); };
     ////////////////////////////////////////////////////////////////////////////////////
     ROUTER_RESOLVE = [this](const fURI &furi) -> fURI { return this->resolve(furi); };
     ////////////////////////////////////////////////////////////////////////////////////
@@ -80,19 +81,18 @@ namespace fhatos {
   }
 
   void Router::push_frame(const Pattern &pattern, const Rec_p &frame_data) {
-    THREAD_FRAME_STACK = make_shared<Frame<>>(pattern, THREAD_FRAME_STACK, frame_data);
+    THREAD_FRAME_STACK.push(pattern, frame_data);
   }
 
   void Router::pop_frame() {
-    if(nullptr == THREAD_FRAME_STACK)
-      throw fError("there are no more frames on the stack");
-    THREAD_FRAME_STACK = THREAD_FRAME_STACK->previous_;
+    THREAD_FRAME_STACK.pop();
   }
 
   void Router::loop() const {
     const uint8_t size = this->structures_->size();
     this->structures_->remove_if([this](const Structure_p &s) {
       if(!s->available()) {
+        this->unindex_structure(s);
         LOG_WRITE(INFO, this, L("!b{} !y{}!! detached\n", s->pattern->toString(), s->tid->name()));
         return true;
       } else {
@@ -100,8 +100,11 @@ namespace fhatos {
         return false;
       }
     });
-    if(this->structures_->size() != size)
+    if(this->structures_->size() != size) {
+      Compiler::inst_cache_clear();
+      Compiler::type_cache_clear();
       this->save();
+    }
   }
 
   void Router::stop() {
@@ -145,8 +148,11 @@ namespace fhatos {
         }
       });
       this->structures_->push_back(structure);
+      this->index_structure(structure);
       structure->setup();
       if(structure->available()) {
+        Compiler::inst_cache_clear();
+        Compiler::type_cache_clear();
         LOG_WRITE(INFO, this,
                   L("!y{} !b{} !yspanning !b{}!! mounted\n", structure->tid->name(),
                     structure->vid ? structure->vid->toString().c_str() : "<none>", structure->pattern->toString()));
@@ -155,6 +161,7 @@ namespace fhatos {
         LOG_WRITE(ERROR, this,
                   L("!runable to mount!! {}: {} at {}!!\n", structure->pattern->toString(), structure->tid->name(),
                     structure->vid ? structure->vid->toString() : "<none>"));
+        this->unindex_structure(structure);
         this->structures_->pop_back();
       }
     }
@@ -171,8 +178,8 @@ namespace fhatos {
 
   [[nodiscard]] Objs_p Router::read(const fURI &furi) const {
     try {
-      if(THREAD_FRAME_STACK) {
-        if(const Obj_p frame_obj = THREAD_FRAME_STACK->read(furi); nullptr != frame_obj)
+      if(!THREAD_FRAME_STACK.empty()) {
+        if(const Obj_p frame_obj = THREAD_FRAME_STACK.read(furi); nullptr != frame_obj)
           return frame_obj;
       }
       const fURI resolved_furi = this->resolve(furi);
@@ -202,8 +209,11 @@ namespace fhatos {
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     try {
-      if(const Structure_p structure = this->get_structure(furi, obj))
+      if(const Structure_p structure = this->get_structure(furi, obj)) {
         structure->write(furi, obj, retain);
+        Compiler::inst_cache_invalidate(furi, obj);
+        Compiler::type_cache_invalidate(furi, obj);
+      }
     } catch(const fError &e) {
       if(!BOOTING)
         throw;
@@ -266,17 +276,50 @@ namespace fhatos {
     return nullptr;
   }
 
+  void Router::index_structure(const Structure_p &structure) const {
+    auto lock = std::lock_guard<Mutex>(this->structure_index_mutex_);
+    this->structure_index_->insert(*structure->pattern, {this->structure_counter_++, structure});
+  }
+
+  void Router::unindex_structure(const Structure_p &structure) const {
+    auto lock = std::lock_guard<Mutex>(this->structure_index_mutex_);
+    this->structure_index_->remove_if(*structure->pattern, [&structure](const Pair<uint64_t, Structure_p> &entry) {
+      return entry.second == structure;
+    });
+  }
+
   Structure_p Router::get_structure(const Pattern &pattern, const Obj_p &to_write, const bool throw_on_error) const {
     // const Pattern_p temp = pattern->is_branch() ? p_p(pattern->extend("+")) : pattern;
     Structure_p found = nullptr;
-    for(const Structure_p &s: *this->structures_) {
-      if(to_write && to_write->is_noobj() && s->vid && pattern.bimatches(*s->vid)) {
-        s->stop();
-      } else {
-        if(const auto p = Pattern(*s->pattern); pattern.bimatches(p)) {
+    if(to_write && to_write->is_noobj()) {
+      // noobj writes stop the structures they address (by vid) so all structures are visited
+      for(const Structure_p &s: *this->structures_) {
+        if(s->vid && pattern.bimatches(*s->vid)) {
+          s->stop();
+        } else {
+          if(pattern.bimatches(*s->pattern)) {
+            if(found && throw_on_error)
+              throw fError("!b%s!! crosses multiple structures", pattern.toString().c_str());
+            found = s;
+          }
+        }
+      }
+    } else {
+      List<Pair<uint64_t, Structure_p>> candidates;
+      {
+        auto lock = std::shared_lock<Mutex>(this->structure_index_mutex_);
+        this->structure_index_->match(pattern, &candidates);
+      }
+      // the most recently mounted structure wins (as with a linear scan)
+      uint64_t found_order = 0;
+      for(const auto &[order, s]: candidates) {
+        if(pattern.bimatches(*s->pattern)) {
           if(found && throw_on_error)
             throw fError("!b%s!! crosses multiple structures", pattern.toString().c_str());
-          found = s;
+          if(!found || order > found_order) {
+            found = s;
+            found_order = order;
+          }
         }
       }
     }
@@ -22,6 +22,7 @@
 
 #include "../../../../fhatos.hpp"
 #include "../../../../lang/obj.hpp"
+#include "../../../../util/pattern_trie.hpp"
 #include "../../s/frame.hpp"
 #include "memory/memory.hpp"
 #include "structure.hpp"
@@ -36,6 +37,10 @@ namespace fhatos {
   class Router final : public Rec {
   protected:
     const ptr<MutexDeque<Structure_p>> structures_;
+    /// structure patterns indexed by path segment (paired with their mount order)
+    const ptr<PatternTrie<Pair<uint64_t, Structure_p>>> structure_index_;
+    mutable Mutex structure_index_mutex_;
+    mutable uint64_t structure_counter_ = 0;
 
   public:
     std::vector<Uri_p> auto_prefixes_;
@@ -65,7 +70,7 @@ namespace fhatos {
 
     static void pop_frame();
 
-    static ptr<Frame<>> get_frame();
+    static FrameStack &get_frame();
 
     static void *import();
 
@@ -96,6 +101,10 @@ namespace fhatos {
     }
 
   protected:
+    void index_structure(const Structure_p &structure) const;
+
+    void unindex_structure(const Structure_p &structure) const;
+
     [[nodiscard]] Structure_p get_structure(const Pattern &pattern, const Obj_p &to_write = nullptr,
                                             bool throw_on_error = true) const;
   };
@@ -57,7 +57,7 @@ namespace fhatos {
   }
 
   void Structure::append(const fURI &furi, const Obj_p &obj) {
-    if(const Obj_p collection = this->read(furi); collection->is_lst()) {
+    if(const Obj_p collection = this->mutable_copy(this->read(furi)); collection->is_lst()) {
       collection->lst_add(obj);
       this->write(furi, collection, true);
     } else if(collection->is_rec() && obj->is_rec()) {
@@ -218,7 +218,7 @@ namespace fhatos {
           if(const auto pair = this->locate_base_poly(new_furi.retract()); pair.has_value()) {
             /*LOG_WRITE(TRACE, this,L("base poly found at {}: {}\n",
                                     pair->first.toString(), pair->second->toString()));*/
-            if(const Poly_p poly_insert = pair->second; poly_insert->is_poly()) {
+            if(const Poly_p poly_insert = this->mutable_copy(pair->second); poly_insert->is_poly()) {
               const string furi_branch = pair->first.as_branch().toString();
               const fURI id_insert = new_furi.remove_subpath(furi_branch, true).as_node();
               if(obj->is_noobj())
@@ -56,6 +56,12 @@ namespace fhatos {
 
     Obj_p read_internal(const fURI &furi);
 
+    /// true when read_raw_pairs() hands out the stored objs (copy-on-write)
+    [[nodiscard]] virtual bool shares_objs() const { return false; }
+
+    /// a private copy of a read obj that is about to be mutated
+    [[nodiscard]] Obj_p mutable_copy(const Obj_p &obj) const { return this->shares_objs() ? obj->clone() : obj; }
+
   public:
     const Pattern_p pattern{};
     Structure_p shared_from_this() { return ptr<Structure>(this); }
@@ -19,6 +19,7 @@ FhatOS: A Distributed Operating System
 #ifndef fhatos_thread_hpp
 #define fhatos_thread_hpp
 #include "../../../../../fhatos.hpp"
+#include "../../../../../lang/mmadt/closure.hpp"
 #include "../../../../../lang/mmadt/mmadt_obj.hpp"
 #include "../../../../../lang/obj.hpp"
 #include "../../../../../structure/pubsub.hpp"
@@ -79,9 +80,10 @@ namespace fhatos {
                       L("!g[!bfhatos!g] !ythread!! spawned: {} !m[!ystack size:!!{}!m]!!\n",
                         thread_loop_inst->toString(),
                         Memory::singleton()->get_stack_size(thread_ptr->thread_obj_, "config/stack_size", 65536)));
+            Closure thread_loop(thread_loop_inst);
             while(!thread_ptr->thread_obj_->obj_get("halt")->or_else_<bool>(false)) {
               try {
-                thread_loop_inst->apply(thread_ptr->thread_obj_);
+                thread_loop.apply(thread_ptr->thread_obj_);
                 FEED_WATCHDOG();
               } catch(const fError &e) {
                 LOG_WRITE(ERROR, thread_ptr->thread_obj_.get(), L("!rthread loop error!!: {}\n", e.what()));
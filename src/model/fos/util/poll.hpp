@@ -20,6 +20,7 @@
 #define fhatos_util_poll_hpp
 
 #include "../../../fhatos.hpp"
+#include "../../../lang/mmadt/closure.hpp"
 #include "../../../lang/obj.hpp"
 #include "../../model.hpp"
 #include "../sys/scheduler/thread/thread.hpp"
@@ -42,9 +43,15 @@ namespace fhatos {
           LOG_WRITE(INFO, poll_obj.get(), L("!ypolling !b{} !ystarted!! [delay:{} ms]\n",
                                             poll_obj->rec_get("loop")->toString(),
                                             poll_obj->get<int>("delay")));
+          Obj_p code = nullptr;
+          uptr<Closure> loop = nullptr;
           while(!poll_obj->get<bool>("halt")) {
-            const Obj_p code = poll_obj->rec_get("loop");
-            const Obj_p result = BCODE_PROCESSOR(code);
+            // the loop is recompiled only when it is reassigned
+            if(const Obj_p current = poll_obj->rec_get("loop"); current != code) {
+              code = current;
+              loop = make_unique<Closure>(code);
+            }
+            const Obj_p result = loop->apply(Obj::to_noobj());
             Thread::delay(poll_obj->get<int>("delay"));
           }
           const std::chrono::duration<double, milli> duration = std::chrono::high_resolution_clock::now() - start_time;
@@ -46,7 +46,8 @@ namespace fhatos {
     [[nodiscard]] FOS_REAL_TYPE duration() const {
       const auto endTime = std::chrono::steady_clock::now();
       const auto duration = std::chrono::duration<double>(endTime - this->start_time);
-      const_cast<any *>(&this->value_)->emplace<FOS_REAL_TYPE>(duration.count());
+      const_cast<Time *>(this)->value_ = static_cast<FOS_REAL_TYPE>(duration.count());
+      this->hash_.store(0);
       return duration.count();
     }
 
@@ -24,6 +24,7 @@
 #include "../lang/obj.hpp"
 #include "../util/mutex_deque.hpp"
 #include "../util/obj_helper.hpp"
+#include "../util/pattern_trie.hpp"
 
 #define SUBSCRIPTION_TID FOS_URI "/q/sub/sub"
 #define MESSAGE_TID FOS_URI "/q/sub/msg"
@@ -154,9 +155,67 @@ namespace fhatos {
     std::optional<Mail> next_mail() const { return this->mailbox_->pop_front(); }
   };
 
+  ////////////////////////////////////////////////////
+  /////////////// SUBSCRIPTION INDEX ////////////////
+  ////////////////////////////////////////////////////
+
+  /// subscriptions indexed by pattern segment (an mqtt-style topic tree)
+  class Subscriptions {
+  protected:
+    PatternTrie<Subscription_p> trie_;
+    mutable Mutex mutex_;
+
+  public:
+    Subscriptions() = default;
+
+    void push_back(const Subscription_p &subscription) {
+      const Pattern_p pattern = subscription->pattern();
+      auto lock = std::lock_guard<Mutex>(this->mutex_);
+      this->trie_.insert(*pattern, subscription);
+    }
+
+    /// the subscriptions whose pattern may bimatch the furi
+    [[nodiscard]] List<Subscription_p> match(const fURI &furi) const {
+      auto lock = std::shared_lock<Mutex>(this->mutex_);
+      return this->trie_.match(furi);
+    }
+
+    /// remove the subscriptions (whose pattern may bimatch the pattern) that satisfy the predicate
+    List<Subscription_p> remove_if(const fURI &pattern, const Predicate<const Subscription_p &> &predicate) {
+      List<Subscription_p> removed;
+      for(const Subscription_p &sub: this->match(pattern)) {
+        if(predicate(sub))
+          removed.push_back(sub);
+      }
+      auto lock = std::lock_guard<Mutex>(this->mutex_);
+      for(const Subscription_p &sub: removed) {
+        this->trie_.remove_if(*sub->pattern(), [&sub](const Subscription_p &s) { return s == sub; });
+      }
+      return removed;
+    }
+
+    void forEach(const Consumer<const Subscription_p &> &consumer) const {
+      List<Subscription_p> subscriptions;
+      {
+        auto lock = std::shared_lock<Mutex>(this->mutex_);
+        this->trie_.for_each([&subscriptions](const Subscription_p &sub) { subscriptions.push_back(sub); });
+      }
+      for(const Subscription_p &sub: subscriptions) {
+        consumer(sub);
+      }
+    }
+
+    [[nodiscard]] size_t size() const {
+      auto lock = std::shared_lock<Mutex>(this->mutex_);
+      return this->trie_.size();
+    }
+
+    [[nodiscard]] bool empty() const { return 0 == this->size(); }
+  };
+
   class Post : public Mailbox {
   public:
-    ptr<MutexDeque<Subscription_p>> subscriptions_ = make_shared<MutexDeque<Subscription_p>>();
+    ptr<Subscriptions> subscriptions_ = make_shared<Subscriptions>();
     explicit Post() : Mailbox() {};
     Post(const Post &other) : Mailbox(other), subscriptions_(other.subscriptions_) {}
     Post(Post &&other) noexcept : Mailbox(other) {
@@ -169,8 +228,9 @@ namespace fhatos {
     virtual void publish(const Message_p &message, bool async) const = 0;
     virtual void loop() {};
     virtual void receive(const Message_p &message, bool async) const {
-      for(const Subscription_p &sub: *this->subscriptions_) {
-        if(message->target()->bimatches(*sub->pattern())) {
+      const ID_p target = message->target();
+      for(const Subscription_p &sub: this->subscriptions_->match(*target)) {
+        if(target->bimatches(*sub->pattern())) {
           const auto mail = Mail(sub, message);
 /*        const Obj_p source_obj = ROUTER_READ(*sub->source());
            if(const auto source_mailbox = source_obj->get_model<Obj>(false);
@@ -203,7 +263,7 @@ namespace fhatos {
     }
 
     void unsubscribe(const ID &source, const Pattern &pattern, const bool async) override {
-      this->subscriptions_->remove_if([this, &pattern, &source](const Subscription_p &sub) {
+      this->subscriptions_->remove_if(pattern, [this, &pattern, &source](const Subscription_p &sub) {
         const bool removing = sub->source()->equals(source) && (sub->pattern()->matches(pattern));
         if(removing)
           LOG_WRITE(DEBUG, ROUTER_READ(source).get(),
@@ -153,7 +153,7 @@ namespace fhatos {
   }
 
   void MqttClient::unsubscribe(const ID &source, const Pattern &pattern, const bool async) {
-    this->subscriptions_->remove_if([this, &source, &pattern](const Subscription_p &sub) {
+    this->subscriptions_->remove_if(pattern, [this, &source, &pattern](const Subscription_p &sub) {
       const bool remove = pattern.bimatches(*sub->pattern()) && sub->source()->equals(source);
       if(remove) {
         const auto h = std::any_cast<ptr<ESP_CLIENT_NAME>>(this->handler_);
@@ -170,7 +170,7 @@ namespace fhatos {
     if(message->payload()->is_noobj()) {
       h->publish(message->target()->toString().c_str(), 0, message->retain(), nullptr, 0);
     } else {
-      const BObj_p source_payload = make_bobj(message->payload(), message->retain());
+      const BObj_p source_payload = make_bobj(message->payload(), message->retain(), this->codec_);
       h->publish(message->target()->toString().c_str(), 0, message->retain(), source_payload->second,
                  source_payload->first);
     }
@@ -227,9 +227,8 @@ namespace fhatos {
       if(!this->subscriptions_->empty()) {
         LOG_WRITE(INFO, this,
                   L("!yresubscribing to subscription(s) !g[!msize:{}!g]!!\n", this->subscriptions_->size()));
-        for(const auto &sub: *this->subscriptions_) {
-          h->subscribe(sub->pattern()->toString().c_str(), 0);
-        }
+        this->subscriptions_->forEach(
+            [&h](const Subscription_p &sub) { h->subscribe(sub->pattern()->toString().c_str(), 0); });
       }
       // this->on_connect();
     } catch(const std::exception &e) {
@@ -23,6 +23,7 @@ FhatOS: A Distributed Operating System
 #include "../../../fhatos.hpp"
 #include "../../../lang/obj.hpp"
 #include "../../../model/fos/sys/router/structure.hpp"
+#include "../../../util/obj_codec.hpp"
 
 namespace fhatos {
   class MqttClient;
@@ -34,6 +35,8 @@ namespace fhatos {
     std::any handler_;
     Runnable on_connect = [] {};
     uptr<MutexDeque<ID>> clients_ = make_unique<MutexDeque<ID>>();
+    /// the payload encoding of published messages (received payloads are decoded in either codec)
+    Codec codec_ = Codec::TEXT;
 
     explicit MqttClient(const Rec_p &config);
 
@@ -49,21 +52,23 @@ namespace fhatos {
 
     [[nodiscard]] bool disconnect(const ID &source, bool async = true);
 
-    static BObj_p make_bobj(const Obj_p &payload, const bool retain) {
+    static BObj_p make_bobj(const Obj_p &payload, const bool retain, const Codec codec = Codec::TEXT) {
       const Lst_p lst = Obj::to_lst({payload, dool(retain)});
-      return lst->serialize();
+      return ObjCodec::encode(lst, codec);
     }
 
     static Pair<Obj_p, bool> make_payload(const BObj_p &bobj) {
-      const Lst_p lst = Obj::deserialize(bobj);
+      const Lst_p lst = ObjCodec::decode(bobj);
       return {lst->lst_value()->at(0), lst->lst_value()->at(1)->bool_value()};
     }
 
 
-    static ptr<MqttClient> get_or_create(const fURI &broker, const fURI &client) {
+    static ptr<MqttClient> get_or_create(const fURI &broker, const fURI &client, const Codec codec = Codec::TEXT) {
       if(CLIENTS.count(broker))
         return CLIENTS.at(broker);
-      auto mqtt = make_shared<MqttClient>(Obj::to_rec({{"broker", vri(broker)}, {"client", vri(client)}}));
+      auto mqtt = make_shared<MqttClient>(Obj::to_rec(
+          {{"broker", vri(broker)}, {"client", vri(client)}, {"codec", vri(Codecs.to_chars(codec))}}));
+      mqtt->codec_ = codec;
       CLIENTS.insert_or_assign(broker, mqtt);
       return mqtt;
     }
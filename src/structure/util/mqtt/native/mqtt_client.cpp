@@ -66,7 +66,7 @@ namespace fhatos {
   }
 
   void MqttClient::unsubscribe(const ID &source, const Pattern &pattern, const bool async) {
-    this->subscriptions_->remove_if([this, &source, &pattern, async](const Subscription_p &sub) {
+    this->subscriptions_->remove_if(pattern, [this, &source, &pattern, async](const Subscription_p &sub) {
       const bool remove = pattern.bimatches(*sub->pattern()) && sub->source()->equals(source);
       if(remove) {
         const mqtt::token_ptr result =
@@ -84,7 +84,7 @@ namespace fhatos {
       result = std::any_cast<ptr<async_client>>(this->handler_)
                    ->publish(message->target()->toString().c_str(), const_cast<char *>(""), 0, 1, message->retain());
     } else {
-      const BObj_p source_payload = make_bobj(message->payload(), message->retain());
+      const BObj_p source_payload = make_bobj(message->payload(), message->retain(), this->codec_);
       result = std::any_cast<ptr<async_client>>(this->handler_)
                    ->publish(message->target()->toString(), source_payload->second, source_payload->first, 1,
                              message->retain());
@@ -141,7 +141,7 @@ namespace fhatos {
                                                            .keep_alive_interval(std::chrono::seconds(20))
                                                            .automatic_reconnect();
       if(!this->rec_get("config/will")->is_noobj()) {
-        const BObj_p source_payload = this->rec_get("config/will")->rec_get("payload")->serialize();
+        const BObj_p source_payload = ObjCodec::encode(this->rec_get("config/will")->rec_get("payload"), this->codec_);
         pre_connection_options = pre_connection_options.will(
             message(this->rec_get("config/will")->rec_get("target")->uri_value().toString(), source_payload->second,
                     this->rec_get("config/will")->rec_get("retain")->bool_value()));
@@ -0,0 +1,97 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#pragma once
+#ifndef fhatos_lru_cache_hpp
+#define fhatos_lru_cache_hpp
+
+#include "../model/fos/sys/scheduler/thread/mutex.hpp"
+#include <atomic>
+#include <list>
+#include <optional>
+#include <unordered_map>
+
+namespace fhatos {
+  /// a bounded map that evicts its least recently used entry (entries are stamped with a version and
+  /// an entry of another version is a miss)
+  template<typename KEY, typename VALUE, typename HASH = std::hash<KEY>>
+  class LRUCache {
+  protected:
+    struct Entry {
+      KEY key;
+      VALUE value;
+      long version;
+    };
+
+    const size_t capacity_;
+    std::list<Entry> entries_; // most recently used first
+    std::unordered_map<KEY, typename std::list<Entry>::iterator, HASH> index_;
+    Mutex mutex_;
+
+  public:
+    std::atomic<long> hits{0};
+    std::atomic<long> misses{0};
+    std::atomic<long> evictions{0};
+
+    explicit LRUCache(const size_t capacity) : capacity_(capacity) {}
+
+    std::optional<VALUE> get(const KEY &key, const long version) {
+      auto lock = std::lock_guard<Mutex>(this->mutex_);
+      const auto it = this->index_.find(key);
+      if(it == this->index_.end() || it->second->version != version) {
+        ++this->misses;
+        return std::nullopt;
+      }
+      this->entries_.splice(this->entries_.begin(), this->entries_, it->second);
+      ++this->hits;
+      return it->second->value;
+    }
+
+    void put(const KEY &key, const VALUE &value, const long version) {
+      if(0 == this->capacity_)
+        return;
+      auto lock = std::lock_guard<Mutex>(this->mutex_);
+      if(const auto it = this->index_.find(key); it != this->index_.end()) {
+        it->second->value = value;
+        it->second->version = version;
+        this->entries_.splice(this->entries_.begin(), this->entries_, it->second);
+        return;
+      }
+      if(this->entries_.size() >= this->capacity_) {
+        this->index_.erase(this->entries_.back().key);
+        this->entries_.pop_back();
+        ++this->evictions;
+      }
+      this->entries_.push_front(Entry{key, value, version});
+      this->index_.insert_or_assign(key, this->entries_.begin());
+    }
+
+    void clear() {
+      auto lock = std::lock_guard<Mutex>(this->mutex_);
+      this->entries_.clear();
+      this->index_.clear();
+    }
+
+    [[nodiscard]] size_t size() {
+      auto lock = std::lock_guard<Mutex>(this->mutex_);
+      return this->entries_.size();
+    }
+
+    [[nodiscard]] size_t capacity() const { return this->capacity_; }
+  };
+} // namespace fhatos
+#endif
@@ -0,0 +1,327 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#pragma once
+#ifndef fhatos_obj_codec_hpp
+#define fhatos_obj_codec_hpp
+
+#include "../fhatos.hpp"
+#include "../lang/obj.hpp"
+#include <cstring>
+
+#define FOS_CODEC_MAGIC 0xF0
+#define FOS_CODEC_VERSION 0x01
+
+namespace fhatos {
+  enum class Codec { TEXT, BINARY };
+
+  static const auto Codecs = Enums<Codec>({{Codec::TEXT, "text"}, {Codec::BINARY, "binary"}});
+
+  /// obj <=> bytes
+  ///   text:   the SERIALIZER_PRINTER string (parsed back with OBJ_PARSER)
+  ///   binary: [magic][version] then a tagged obj tree
+  ///           tag byte = otype | flags, ints are zigzag varints, uris (values/tids/vids) are interned per payload
+  ///           insts, bcodes, types, and errors are embedded as serializer text
+  /// decode() detects the codec from the magic byte so readers accept either
+  class ObjCodec {
+  protected:
+    static constexpr uint8_t OTYPE_MASK = 0x0F;
+    static constexpr uint8_t HAS_TID = 0x10;
+    static constexpr uint8_t HAS_VID = 0x20;
+    static constexpr uint8_t AS_TEXT = 0x40;
+
+    class Writer {
+      string bytes_;
+      Map<string, uint32_t> uris_;
+
+    public:
+      Writer() {
+        this->bytes_.reserve(64);
+        this->bytes_.push_back(static_cast<char>(FOS_CODEC_MAGIC));
+        this->bytes_.push_back(static_cast<char>(FOS_CODEC_VERSION));
+      }
+
+      void byte(const uint8_t b) { this->bytes_.push_back(static_cast<char>(b)); }
+
+      void varint(uint64_t v) {
+        while(v >= 0x80) {
+          this->byte(static_cast<uint8_t>(v | 0x80));
+          v >>= 7;
+        }
+        this->byte(static_cast<uint8_t>(v));
+      }
+
+      void chars(const char *s, const size_t length) {
+        this->varint(length);
+        this->bytes_.append(s, length);
+      }
+
+      /// 0 followed by the chars the first time, the uri's table index (1-based) thereafter
+      void uri(const fURI &furi) {
+        const string s = furi.toString();
+        if(const auto it = this->uris_.find(s); it != this->uris_.end()) {
+          this->varint(it->second);
+          return;
+        }
+        this->varint(0);
+        this->chars(s.c_str(), s.length());
+        this->uris_.emplace(s, this->uris_.size() + 1);
+      }
+
+      void obj(const Obj_p &obj) {
+        const uint8_t otype = static_cast<uint8_t>(obj->otype);
+        bool text;
+        switch(obj->otype) {
+          case OType::NOOBJ:
+          case OType::BOOL:
+          case OType::INT:
+          case OType::REAL:
+          case OType::STR:
+          case OType::URI:
+          case OType::LST:
+          case OType::REC:
+          case OType::OBJS:
+            text = false;
+            break;
+          default:
+            text = true;
+        }
+        if(text) {
+          this->byte(otype | AS_TEXT);
+          const string serial = obj->toString(SERIALIZER_PRINTER);
+          this->chars(serial.c_str(), serial.length());
+          return;
+        }
+        const bool has_tid = obj->tid && !(OTYPE_FURI.count(obj->otype) && obj->tid->equals(*OTYPE_FURI.at(obj->otype)));
+        const bool has_vid = obj->vid != nullptr;
+        this->byte(otype | (has_tid ? HAS_TID : 0) | (has_vid ? HAS_VID : 0));
+        if(has_tid)
+          this->uri(*obj->tid);
+        if(has_vid)
+          this->uri(*obj->vid);
+        switch(obj->otype) {
+          case OType::NOOBJ:
+            break;
+          case OType::BOOL:
+            this->byte(obj->bool_value() ? 1 : 0);
+            break;
+          case OType::INT: {
+            const auto i = static_cast<int64_t>(obj->int_value());
+            this->varint((static_cast<uint64_t>(i) << 1) ^ static_cast<uint64_t>(i >> 63));
+            break;
+          }
+          case OType::REAL: {
+            const auto d = static_cast<double>(obj->real_value());
+            char raw[sizeof(double)];
+            memcpy(raw, &d, sizeof(double));
+            this->bytes_.append(raw, sizeof(double));
+            break;
+          }
+          case OType::STR: {
+            const string s = obj->str_value();
+            this->chars(s.c_str(), s.length());
+            break;
+          }
+          case OType::URI:
+            this->uri(obj->uri_value());
+            break;
+          case OType::LST: {
+            const Obj::LstList_p list = obj->lst_value();
+            this->varint(list->size());
+            for(const auto &o: *list) {
+              this->obj(o);
+            }
+            break;
+          }
+          case OType::OBJS: {
+            const List_p<Obj_p> list = obj->objs_value();
+            this->varint(list->size());
+            for(const auto &o: *list) {
+              this->obj(o);
+            }
+            break;
+          }
+          case OType::REC: {
+            const Obj::RecMap_p<> map = obj->rec_value();
+            this->varint(map->size());
+            for(const auto &[k, v]: *map) {
+              this->obj(k);
+              this->obj(v);
+            }
+            break;
+          }
+          default:
+            break;
+        }
+      }
+
+      [[nodiscard]] BObj_p bobj() const {
+        auto *bytes = static_cast<fbyte *>(malloc(this->bytes_.length()));
+        memcpy(bytes, this->bytes_.data(), this->bytes_.length());
+        return ptr<BObj>(new BObj(this->bytes_.length(), bytes), bobj_deleter);
+      }
+    };
+
+    class Reader {
+      const fbyte *bytes_;
+      const fbyte *end_;
+      List<ID_p> uris_;
+
+      void need(const size_t length) const {
+        if(static_cast<size_t>(this->end_ - this->bytes_) < length)
+          throw fError("!rcorrupt!! binary obj: !yunexpected end of bytes!!");
+      }
+
+      /// decoded objs were type checked when they were encoded and are not re-written to their vid
+      static Obj_p make(const ObjValue &value, const OType otype, const ID_p &tid, const ID_p &vid) {
+        return make_shared<Obj>(value, otype, tid, vid);
+      }
+
+    public:
+      Reader(const fbyte *bytes, const uint32_t length) : bytes_(bytes), end_(bytes + length) {}
+
+      uint8_t byte() {
+        this->need(1);
+        return *this->bytes_++;
+      }
+
+      uint64_t varint() {
+        uint64_t v = 0;
+        for(uint8_t shift = 0; shift < 64; shift += 7) {
+          const uint8_t b = this->byte();
+          v |= static_cast<uint64_t>(b & 0x7F) << shift;
+          if(!(b & 0x80))
+            return v;
+        }
+        throw fError("!rcorrupt!! binary obj: !yvarint overflow!!");
+      }
+
+      string chars() {
+        const uint64_t length = this->varint();
+        this->need(length);
+        string s(reinterpret_cast<const char *>(this->bytes_), length);
+        this->bytes_ += length;
+        return s;
+      }
+
+      ID_p uri() {
+        const uint64_t index = this->varint();
+        if(0 == index) {
+          this->uris_.push_back(id_p(this->chars().c_str()));
+          return this->uris_.back();
+        }
+        if(index > this->uris_.size())
+          throw fError("!rcorrupt!! binary obj: !yuri index %i out of range!!", static_cast<int>(index));
+        return this->uris_.at(index - 1);
+      }
+
+      Obj_p obj() {
+        const uint8_t tag = this->byte();
+        const auto otype = static_cast<OType>(tag & OTYPE_MASK);
+        if(tag & AS_TEXT)
+          return OBJ_PARSER(this->chars());
+        const ID_p tid = (tag & HAS_TID) ? this->uri() : OTYPE_FURI.at(otype);
+        const ID_p vid = (tag & HAS_VID) ? this->uri() : nullptr;
+        const bool plain = !(tag & (HAS_TID | HAS_VID));
+        switch(otype) {
+          case OType::NOOBJ:
+            return Obj::to_noobj();
+          case OType::BOOL:
+            return plain ? Obj::to_bool(0 != this->byte()) : make(0 != this->byte(), otype, tid, vid);
+          case OType::INT: {
+            const uint64_t z = this->varint();
+            const auto i = static_cast<FOS_INT_TYPE>(static_cast<int64_t>(z >> 1) ^ -static_cast<int64_t>(z & 1));
+            return plain ? Obj::to_int(i) : make(i, otype, tid, vid);
+          }
+          case OType::REAL: {
+            this->need(sizeof(double));
+            double d;
+            memcpy(&d, this->bytes_, sizeof(double));
+            this->bytes_ += sizeof(double);
+            return make(static_cast<FOS_REAL_TYPE>(d), otype, tid, vid);
+          }
+          case OType::STR:
+            return make(this->chars(), otype, tid, vid);
+          case OType::URI:
+            return make(static_cast<const fURI &>(*this->uri()), otype, tid, vid);
+          case OType::LST: {
+            const uint64_t size = this->varint();
+            const auto list = make_shared<Obj::LstList>();
+            list->reserve(size);
+            for(uint64_t i = 0; i < size; i++) {
+              list->push_back(this->obj());
+            }
+            return make(list, otype, tid, vid);
+          }
+          case OType::OBJS: {
+            const uint64_t size = this->varint();
+            const auto list = make_shared<List<Obj_p>>();
+            list->reserve(size);
+            for(uint64_t i = 0; i < size; i++) {
+              list->push_back(this->obj());
+            }
+            return make(list, otype, tid, vid);
+          }
+          case OType::REC: {
+            const uint64_t size = this->varint();
+            const auto map = make_shared<Obj::RecMap<>>();
+            map->reserve(size);
+            for(uint64_t i = 0; i < size; i++) {
+              const Obj_p key = this->obj();
+              map->insert_or_assign(key, this->obj());
+            }
+            return make(map, otype, tid, vid);
+          }
+          default:
+            throw fError("!rcorrupt!! binary obj: !yunknown tag %i!!", static_cast<int>(tag));
+        }
+      }
+    };
+
+  public:
+    static bool is_binary(const BObj_p &bobj) {
+      return bobj->first >= 2 && FOS_CODEC_MAGIC == bobj->second[0];
+    }
+
+    /// the codec named by a structure/client config value (text when unspecified)
+    static Codec codec(const Obj_p &config_value) {
+      if(config_value->is_uri())
+        return Codecs.to_enum(config_value->uri_value().toString());
+      if(config_value->is_str())
+        return Codecs.to_enum(config_value->str_value());
+      return Codec::TEXT;
+    }
+
+    static BObj_p encode(const Obj_p &obj, const Codec codec = Codec::BINARY) {
+      if(Codec::TEXT == codec)
+        return obj->serialize();
+      Writer writer;
+      writer.obj(obj);
+      return writer.bobj();
+    }
+
+    static Obj_p decode(const BObj_p &bobj) {
+      if(!is_binary(bobj))
+        return Obj::deserialize(bobj);
+      if(FOS_CODEC_VERSION != bobj->second[1])
+        throw fError("!yunsupported!! binary obj version !r%i!!", static_cast<int>(bobj->second[1]));
+      Reader reader(bobj->second + 2, bobj->first - 2);
+      return reader.obj();
+    }
+  };
+} // namespace fhatos
+#endif
@@ -0,0 +1,205 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#pragma once
+#ifndef fhatos_pattern_trie_hpp
+#define fhatos_pattern_trie_hpp
+
+#include "../fhatos.hpp"
+#include "../furi.hpp"
+#include <cstring>
+#include <map>
+
+namespace fhatos {
+  /// a path segment index of patterns (with + and # wildcard nodes)
+  /// lookups return every value whose pattern may bimatch the furi (callers confirm with fURI::bimatches)
+  /// the trie is not synchronized
+  template<typename T>
+  class PatternTrie {
+  protected:
+    struct Node {
+      std::map<string, uptr<Node>, std::less<>> children;
+      uptr<Node> plus;
+      List<T> values; // patterns ending at this node
+      List<T> hash; // patterns ending with # at this node
+
+      [[nodiscard]] bool empty() const {
+        return this->children.empty() && !this->plus && this->values.empty() && this->hash.empty();
+      }
+    };
+
+    Node root_;
+    List<T> unindexed_; // patterns with an authority, components, or : names
+    size_t size_ = 0;
+
+    static bool indexable(const fURI &furi) {
+      return !furi.has_scheme() && !furi.has_host() && !furi.has_user() && !furi.has_password() &&
+             !furi.has_components() && furi.path_length() > 0 && ':' != furi.segment(0)[0];
+    }
+
+    static void append(const List<T> &from, List<T> *to) { to->insert(to->end(), from.begin(), from.end()); }
+
+    static void all(const Node *node, List<T> *results) {
+      append(node->values, results);
+      append(node->hash, results);
+      if(node->plus)
+        all(node->plus.get(), results);
+      for(const auto &[segment, child]: node->children) {
+        all(child.get(), results);
+      }
+    }
+
+    static void match(const Node *node, const fURI &furi, const uint8_t index, List<T> *results) {
+      append(node->hash, results);
+      if(index >= furi.path_length()) {
+        append(node->values, results);
+        // branches (a/) match a trailing +
+        if(node->plus) {
+          append(node->plus->values, results);
+          append(node->plus->hash, results);
+        }
+        return;
+      }
+      const char *segment = furi.segment(index);
+      if(0 == strcmp(segment, "#")) {
+        append(node->values, results);
+        if(node->plus)
+          all(node->plus.get(), results);
+        for(const auto &[s, child]: node->children) {
+          all(child.get(), results);
+        }
+        return;
+      }
+      if(0 == strcmp(segment, "+")) {
+        for(const auto &[s, child]: node->children) {
+          match(child.get(), furi, index + 1, results);
+        }
+      } else if(const auto it = node->children.find(segment); it != node->children.end()) {
+        match(it->second.get(), furi, index + 1, results);
+      }
+      if(node->plus)
+        match(node->plus.get(), furi, index + 1, results);
+    }
+
+    static size_t remove_if(Node *node, const fURI &pattern, const uint8_t index, const Predicate<const T &> &predicate) {
+      const auto erase = [&predicate](List<T> &list) {
+        const size_t size = list.size();
+        list.erase(std::remove_if(list.begin(), list.end(), predicate), list.end());
+        return size - list.size();
+      };
+      if(index >= pattern.path_length())
+        return erase(node->values);
+      const char *segment = pattern.segment(index);
+      if(0 == strcmp(segment, "#"))
+        return erase(node->hash);
+      size_t removed = 0;
+      if(0 == strcmp(segment, "+")) {
+        if(node->plus) {
+          removed = remove_if(node->plus.get(), pattern, index + 1, predicate);
+          if(node->plus->empty())
+            node->plus.reset();
+        }
+      } else if(const auto it = node->children.find(segment); it != node->children.end()) {
+        removed = remove_if(it->second.get(), pattern, index + 1, predicate);
+        if(it->second->empty())
+          node->children.erase(it);
+      }
+      return removed;
+    }
+
+  public:
+    PatternTrie() = default;
+
+    void insert(const fURI &pattern, const T &value) {
+      this->size_++;
+      if(!indexable(pattern)) {
+        this->unindexed_.push_back(value);
+        return;
+      }
+      Node *node = &this->root_;
+      for(uint8_t i = 0; i < pattern.path_length(); i++) {
+        const char *segment = pattern.segment(i);
+        if(0 == strcmp(segment, "#")) {
+          node->hash.push_back(value);
+          return;
+        }
+        if(0 == strcmp(segment, "+")) {
+          if(!node->plus)
+            node->plus = make_unique<Node>();
+          node = node->plus.get();
+        } else {
+          auto it = node->children.find(segment);
+          if(it == node->children.end())
+            it = node->children.emplace(string(segment), make_unique<Node>()).first;
+          node = it->second.get();
+        }
+      }
+      node->values.push_back(value);
+    }
+
+    /// remove the values stored under the pattern that satisfy the predicate
+    size_t remove_if(const fURI &pattern, const Predicate<const T &> &predicate) {
+      size_t removed;
+      if(!indexable(pattern)) {
+        const size_t size = this->unindexed_.size();
+        this->unindexed_.erase(std::remove_if(this->unindexed_.begin(), this->unindexed_.end(), predicate),
+                               this->unindexed_.end());
+        removed = size - this->unindexed_.size();
+      } else
+        removed = remove_if(&this->root_, pattern, 0, predicate);
+      this->size_ -= removed;
+      return removed;
+    }
+
+    void match(const fURI &furi, List<T> *results) const {
+      append(this->unindexed_, results);
+      if(indexable(furi))
+        match(&this->root_, furi, 0, results);
+      else
+        all(&this->root_, results);
+    }
+
+    [[nodiscard]] List<T> match(const fURI &furi) const {
+      List<T> results;
+      this->match(furi, &results);
+      return results;
+    }
+
+    void for_each(const Consumer<const T &> &consumer) const {
+      List<T> results;
+      all(&this->root_, &results);
+      append(this->unindexed_, &results);
+      for(const T &t: results) {
+        consumer(t);
+      }
+    }
+
+    void clear() {
+      this->root_.children.clear();
+      this->root_.plus.reset();
+      this->root_.values.clear();
+      this->root_.hash.clear();
+      this->unindexed_.clear();
+      this->size_ = 0;
+    }
+
+    [[nodiscard]] size_t size() const { return this->size_; }
+
+    [[nodiscard]] bool empty() const { return 0 == this->size_; }
+  };
+} // namespace fhatos
+#endif
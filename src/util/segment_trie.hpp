@@ -0,0 +1,188 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+#pragma once
+#ifndef fhatos_segment_trie_hpp
+#define fhatos_segment_trie_hpp
+
+
+#include "../fhatos.hpp"
+#include "../furi.hpp"
+#include <cstring>
+#include <map>
+
+namespace fhatos {
+  /// a path segment keyed store of ids (the storage dual of PatternTrie)
+  /// exact lookups are O(depth) and pattern lookups only visit the subtrees the pattern can match
+  /// the trie is not synchronized
+  template<typename T>
+  class SegmentTrie {
+  public:
+    /// return false to stop visiting
+    using Visitor = std::function<bool(const ID &, const T &)>;
+
+  protected:
+    struct Node {
+      std::map<string, uptr<Node>, std::less<>> children;
+      List<Pair<ID, T>> entries; // ids ending at this node (node/branch and authority variants)
+
+      [[nodiscard]] bool empty() const { return this->children.empty() && this->entries.empty(); }
+    };
+
+    Node root_;
+    size_t size_ = 0;
+
+    /// patterns whose matches are decided outside the path (names, authority #) are scanned
+    static bool indexable(const fURI &pattern) {
+      return pattern.path_length() > 0 && ':' != pattern.segment(0)[0] && !strchr(pattern.scheme(), '#') &&
+             !strchr(pattern.host(), '#') && !strchr(pattern.user(), '#') && !strchr(pattern.password(), '#');
+    }
+
+    const Node *find(const fURI &id) const {
+      const Node *node = &this->root_;
+      for(uint8_t i = 0; i < id.path_length(); i++) {
+        const auto it = node->children.find(id.segment(i));
+        if(it == node->children.end())
+          return nullptr;
+        node = it->second.get();
+      }
+      return node;
+    }
+
+    static bool visit_entries(const Node *node, const fURI &pattern, const Visitor &visitor) {
+      for(const auto &[id, value]: node->entries) {
+        if(id.matches(pattern) && !visitor(id, value))
+          return false;
+      }
+      return true;
+    }
+
+    static bool visit_all(const Node *node, const fURI &pattern, const Visitor &visitor) {
+      if(!visit_entries(node, pattern, visitor))
+        return false;
+      for(const auto &[segment, child]: node->children) {
+        if(!visit_all(child.get(), pattern, visitor))
+          return false;
+      }
+      return true;
+    }
+
+    static bool visit(const Node *node, const fURI &pattern, const uint8_t index, const Visitor &visitor) {
+      if(index >= pattern.path_length())
+        return visit_entries(node, pattern, visitor);
+      const char *segment = pattern.segment(index);
+      if(0 == strcmp(segment, "#"))
+        return visit_all(node, pattern, visitor);
+      if(0 == strcmp(segment, "+")) {
+        // a/+ ~ a/
+        if(!visit_entries(node, pattern, visitor))
+          return false;
+        for(const auto &[s, child]: node->children) {
+          if(!visit(child.get(), pattern, index + 1, visitor))
+            return false;
+        }
+        return true;
+      }
+      const auto it = node->children.find(segment);
+      return it == node->children.end() || visit(it->second.get(), pattern, index + 1, visitor);
+    }
+
+    size_t erase(Node *node, const fURI &id, const uint8_t index) {
+      if(index >= id.path_length()) {
+        const size_t size = node->entries.size();
+        node->entries.erase(std::remove_if(node->entries.begin(), node->entries.end(),
+                                           [&id](const Pair<ID, T> &entry) { return entry.first.equals(id); }),
+                            node->entries.end());
+        return size - node->entries.size();
+      }
+      const auto it = node->children.find(id.segment(index));
+      if(it == node->children.end())
+        return 0;
+      const size_t removed = this->erase(it->second.get(), id, index + 1);
+      if(it->second->empty())
+        node->children.erase(it);
+      return removed;
+    }
+
+  public:
+    SegmentTrie() = default;
+
+    void insert_or_assign(const ID &id, const T &value) {
+      Node *node = &this->root_;
+      for(uint8_t i = 0; i < id.path_length(); i++) {
+        auto it = node->children.find(id.segment(i));
+        if(it == node->children.end())
+          it = node->children.emplace(string(id.segment(i)), make_unique<Node>()).first;
+        node = it->second.get();
+      }
+      for(auto &entry: node->entries) {
+        if(entry.first.equals(id)) {
+          entry.second = value;
+          return;
+        }
+      }
+      node->entries.emplace_back(id, value);
+      this->size_++;
+    }
+
+    bool erase(const fURI &id) {
+      const size_t removed = this->erase(&this->root_, id, 0);
+      this->size_ -= removed;
+      return removed > 0;
+    }
+
+    /// the value stored at the id (nullptr if none)
+    [[nodiscard]] const T *get(const fURI &id) const {
+      if(const Node *node = this->find(id)) {
+        for(const auto &[key, value]: node->entries) {
+          if(key.equals(id))
+            return &value;
+        }
+      }
+      return nullptr;
+    }
+
+    /// visit every (id,value) whose id matches the pattern
+    void match(const fURI &pattern, const Visitor &visitor) const {
+      if(indexable(pattern))
+        visit(&this->root_, pattern, 0, visitor);
+      else
+        visit_all(&this->root_, pattern, visitor);
+    }
+
+    /// whether some id matches the pattern (no values are materialized)
+    [[nodiscard]] bool exists(const fURI &pattern) const {
+      bool found = false;
+      this->match(pattern, [&found](const ID &, const T &) {
+        found = true;
+        return false;
+      });
+      return found;
+    }
+
+    void clear() {
+      this->root_.children.clear();
+      this->root_.entries.clear();
+      this->size_ = 0;
+    }
+
+    [[nodiscard]] size_t size() const { return this->size_; }
+
+    [[nodiscard]] bool empty() const { return 0 == this->size_; }
+  };
+} // namespace fhatos
+#endif
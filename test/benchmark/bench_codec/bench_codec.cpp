@@ -0,0 +1,91 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef fhatos_bench_codec_hpp
+#define fhatos_bench_codec_hpp
+
+#define FOS_DEPLOY_ROUTER
+#define FOS_DEPLOY_SCHEDULER
+#define FOS_DEPLOY_PROCESSOR
+#define FOS_DEPLOY_MMADT_TYPE
+#define FOS_DEPLOY_MMADT_EXT_TYPE
+#define FOS_DEPLOY_FOS_TYPE
+#define FOS_DEPLOY_PARSER
+#define FOS_DEPLOY_SHARED_MEMORY /codec/#
+
+#include <chrono>
+#include "../../../src/util/obj_codec.hpp"
+#include "../../test_fhatos.hpp"
+
+#define FOS_BENCH_CODEC_ROUNDS 200
+
+namespace fhatos {
+  double time_codec_rounds(const Runnable &runnable) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < FOS_BENCH_CODEC_ROUNDS; i++) {
+      runnable();
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  /// a mqtt-style [payload,retain] message carrying a sensor rec
+  Obj_p sensor_message(const int readings) {
+    const Lst_p values = Obj::to_lst();
+    for(int i = 0; i < readings; i++) {
+      values->lst_value()->push_back(Obj::to_rec({{"id", vri(string("/sensor/temp/").append(to_string(i % 4)))},
+                                                  {"value", real(20.5f + i)},
+                                                  {"count", jnt(i * 1000)},
+                                                  {"unit", str("celsius")},
+                                                  {"ok", dool(i % 2)}}));
+    }
+    return Obj::to_lst({Obj::to_rec({{"host", vri("/fos/host/alpha")}, {"readings", values}}), dool(true)});
+  }
+
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  void bench_codec_encode_decode() {
+    for(const int readings: {1, 16, 128}) {
+      const Obj_p obj = sensor_message(readings);
+      Map<Codec, Pair<double, double>> timings;
+      Map<Codec, uint32_t> sizes;
+      for(const Codec codec: {Codec::TEXT, Codec::BINARY}) {
+        const BObj_p bobj = ObjCodec::encode(obj, codec);
+        FOS_TEST_OBJ_EQUAL(obj, ObjCodec::decode(bobj));
+        sizes[codec] = bobj->first;
+        timings[codec] = {time_codec_rounds([&obj, codec] { const BObj_p x = ObjCodec::encode(obj, codec); }),
+                          time_codec_rounds([&bobj] { const Obj_p x = ObjCodec::decode(bobj); })};
+      }
+      FOS_TEST_MESSAGE("!y%i readings!! x %i: !rtext!! encode %.2fms decode %.2fms (%i bytes) !m=>!! "
+                       "!gbinary!! encode %.2fms decode %.2fms (%i bytes)",
+                       readings, FOS_BENCH_CODEC_ROUNDS, timings[Codec::TEXT].first, timings[Codec::TEXT].second,
+                       sizes[Codec::TEXT], timings[Codec::BINARY].first, timings[Codec::BINARY].second,
+                       sizes[Codec::BINARY]);
+    }
+  }
+
+  FOS_RUN_TESTS( //
+      FOS_RUN_TEST(bench_codec_encode_decode); //
+  )
+}; // namespace fhatos
+
+SETUP_AND_LOOP();
+
+
+#endif
@@ -0,0 +1,175 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef fhatos_bench_furi_hpp
+#define fhatos_bench_furi_hpp
+
+#define FOS_DEPLOY_ROUTER
+#define FOS_DEPLOY_SCHEDULER
+#define FOS_DEPLOY_MMADT_TYPE
+#define FOS_DEPLOY_FOS_TYPE
+#define FOS_DEPLOY_PARSER
+
+#include <chrono>
+#include "../../../src/furi.hpp"
+#include "../../test_fhatos.hpp"
+
+#define FOS_BENCH_FURI_SIZE 256
+#define FOS_BENCH_FURI_ROUNDS 200
+
+namespace fhatos {
+  double time_furi_rounds(const Runnable &runnable) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < FOS_BENCH_FURI_ROUNDS; i++) {
+      runnable();
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  List<string> furi_strings() {
+    List<string> strings;
+    for(int i = 0; i < FOS_BENCH_FURI_SIZE; i++) {
+      strings.push_back(string("/bench/furi/b").append(to_string(i % 16)).append("/l").append(to_string(i)));
+    }
+    return strings;
+  }
+
+  /// the pre-canonical-string behavior (kept here as the benchmark baseline)
+  struct furi_string_hash {
+    size_t operator()(const fURI &furi) const { return std::hash<std::string>{}(furi.toString()); }
+  };
+
+  struct furi_string_less {
+    bool operator()(const fURI &a, const fURI &b) const { return a.toString() < b.toString(); }
+  };
+
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  void bench_furi_operations() {
+    const List<string> strings = furi_strings();
+    List<fURI> furis;
+    for(const string &s: strings) {
+      furis.emplace_back(s);
+    }
+    const fURI pattern = fURI("/bench/furi/+/#");
+    const fURI exact = fURI("/bench/furi/b7/l7");
+    size_t count = 0;
+    const double parse = time_furi_rounds([&strings, &count] {
+      for(const string &s: strings) {
+        count += fURI(s).path_length();
+      }
+    });
+    const double copy = time_furi_rounds([&furis, &count] {
+      for(const fURI &furi: furis) {
+        const fURI x = furi; // NOLINT
+        count += x.path_length();
+      }
+    });
+    const double extend = time_furi_rounds([&furis, &count] {
+      for(const fURI &furi: furis) {
+        count += furi.extend("x").path_length();
+      }
+    });
+    const double retract = time_furi_rounds([&furis, &count] {
+      for(const fURI &furi: furis) {
+        count += furi.retract().path_length();
+      }
+    });
+    const double to_string = time_furi_rounds([&furis, &count] {
+      for(const fURI &furi: furis) {
+        count += furi.toString().length();
+      }
+    });
+    size_t matched = 0;
+    const double equals = time_furi_rounds([&furis, &exact, &matched] {
+      for(const fURI &furi: furis) {
+        matched += furi.equals(exact) ? 1 : 0;
+      }
+    });
+    const double matches = time_furi_rounds([&furis, &pattern, &matched] {
+      for(const fURI &furi: furis) {
+        matched += furi.matches(pattern) ? 1 : 0;
+      }
+    });
+    TEST_ASSERT_GREATER_THAN_INT(0, count);
+    TEST_ASSERT_EQUAL(FOS_BENCH_FURI_ROUNDS * (1 + FOS_BENCH_FURI_SIZE), matched);
+    const char *labels[] = {"parse", "copy", "extend", "retract", "toString", "equals", "matches"};
+    const double timings[] = {parse, copy, extend, retract, to_string, equals, matches};
+    for(int i = 0; i < 7; i++) {
+      FOS_TEST_MESSAGE("!y%s!! x %i over %i furis: !g%.2fms!!", labels[i], FOS_BENCH_FURI_ROUNDS, FOS_BENCH_FURI_SIZE,
+                       timings[i]);
+    }
+  }
+
+  template<typename HASH>
+  double time_furi_lookups(const List<fURI> &keys, const List<fURI> &probes, size_t *found) {
+    auto map = std::unordered_map<fURI, int, HASH>();
+    for(size_t i = 0; i < keys.size(); i++) {
+      map.insert({keys.at(i), i});
+    }
+    *found = 0;
+    return time_furi_rounds([&map, &probes, found] {
+      for(const fURI &probe: probes) {
+        if(map.count(probe))
+          (*found)++;
+      }
+    });
+  }
+
+  template<typename LESS>
+  double time_furi_sorts(const List<fURI> &furis) {
+    return time_furi_rounds([&furis] {
+      List<fURI> sorted = furis;
+      std::sort(sorted.begin(), sorted.end(), LESS());
+    });
+  }
+
+  void bench_furi_hash_and_order() {
+    List<fURI> keys;
+    List<fURI> probes;
+    for(const string &s: furi_strings()) {
+      keys.emplace_back(s);
+      probes.emplace_back(s); // equal but not identical furis
+    }
+    size_t before_found = 0;
+    size_t after_found = 0;
+    const double before = time_furi_lookups<furi_string_hash>(keys, probes, &before_found);
+    const double after = time_furi_lookups<furi_hash>(keys, probes, &after_found);
+    FOS_TEST_MESSAGE("!yfuri!! map lookups [%i x %i]: !rtoString() hash!! %.2fms !m=>!! !gview() hash!! %.2fms (%.1fx)",
+                     FOS_BENCH_FURI_SIZE, FOS_BENCH_FURI_ROUNDS, before, after, before / (after > 0 ? after : 1));
+    TEST_ASSERT_EQUAL(FOS_BENCH_FURI_SIZE * FOS_BENCH_FURI_ROUNDS, before_found);
+    TEST_ASSERT_EQUAL(FOS_BENCH_FURI_SIZE * FOS_BENCH_FURI_ROUNDS, after_found);
+    const double before_sort = time_furi_sorts<furi_string_less>(keys);
+    const double after_sort = time_furi_sorts<furi_less>(keys);
+    FOS_TEST_MESSAGE("!yfuri!! sorts [%i x %i]: !rtoString() less!! %.2fms !m=>!! !gview() less!! %.2fms (%.1fx)",
+                     FOS_BENCH_FURI_SIZE, FOS_BENCH_FURI_ROUNDS, before_sort, after_sort,
+                     before_sort / (after_sort > 0 ? after_sort : 1));
+  }
+
+  FOS_RUN_TESTS( //
+      FOS_RUN_TEST(bench_furi_operations); //
+      FOS_RUN_TEST(bench_furi_hash_and_order); //
+  )
+}; // namespace fhatos
+
+SETUP_AND_LOOP();
+
+
+#endif
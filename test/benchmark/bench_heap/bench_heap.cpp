@@ -0,0 +1,101 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef fhatos_bench_heap_hpp
+#define fhatos_bench_heap_hpp
+
+#define FOS_DEPLOY_ROUTER
+#define FOS_DEPLOY_SCHEDULER
+#define FOS_DEPLOY_MMADT_TYPE
+#define FOS_DEPLOY_FOS_TYPE
+#define FOS_DEPLOY_PARSER
+#define FOS_DEPLOY_SHARED_MEMORY /bench/#
+
+#include <chrono>
+#include "../../../src/model/fos/s/heap.hpp"
+#include "../../test_fhatos.hpp"
+
+#define FOS_BENCH_HEAP_BRANCHES 100
+#define FOS_BENCH_HEAP_LEAVES 50
+#define FOS_BENCH_HEAP_ROUNDS 20
+
+namespace fhatos {
+  double time_rounds(const Runnable &runnable) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < FOS_BENCH_HEAP_ROUNDS; i++) {
+      runnable();
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  Structure_p create_heap(const char *backend) {
+    const Structure_p heap = Heap<>::create(string("/heap/").append(backend).append("/#").c_str(),
+                                            id_p(string("/mnt/heap_").append(backend).c_str()),
+                                            rec({{"backend", vri(backend)}}));
+    Router::singleton()->attach(heap);
+    for(int i = 0; i < FOS_BENCH_HEAP_BRANCHES; i++) {
+      for(int j = 0; j < FOS_BENCH_HEAP_LEAVES; j++) {
+        heap->write(fURI(string("/heap/").append(backend).append("/b").append(to_string(i)).append("/l").append(
+                             to_string(j))),
+                    jnt(i * j), true);
+      }
+    }
+    return heap;
+  }
+
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  void bench_heap_backends() {
+    Map<string, List<double>> timings;
+    for(const char *backend: {"map", "trie"}) {
+      const Structure_p heap = create_heap(backend);
+      const string prefix = string("/heap/").append(backend);
+      const fURI exact = fURI(prefix + "/b" + to_string(FOS_BENCH_HEAP_BRANCHES / 2) + "/l7");
+      const fURI plus = fURI(prefix + "/+/l7");
+      const fURI hash = fURI(prefix + "/b7/#");
+      const fURI missing = fURI(prefix + "/b7/nothing");
+      FOS_TEST_OBJ_EQUAL(jnt((FOS_BENCH_HEAP_BRANCHES / 2) * 7), heap->read(exact));
+      TEST_ASSERT_EQUAL(FOS_BENCH_HEAP_BRANCHES, heap->read(plus)->objs_value()->size());
+      TEST_ASSERT_EQUAL(FOS_BENCH_HEAP_LEAVES, heap->read(hash)->objs_value()->size());
+      TEST_ASSERT_FALSE(heap->has(missing));
+      timings[backend] = {time_rounds([&heap, &exact] { const Obj_p x = heap->read(exact); }),
+                          time_rounds([&heap, &plus] { const Obj_p x = heap->read(plus); }),
+                          time_rounds([&heap, &hash] { const Obj_p x = heap->read(hash); }),
+                          time_rounds([&heap, &missing] { const bool x = heap->has(missing); })};
+      ROUTER_WRITE(*heap->vid, Obj::to_noobj(), true);
+      Router::singleton()->loop();
+    }
+    const char *labels[] = {"exact read", "+ read", "# read", "has (miss)"};
+    for(int i = 0; i < 4; i++) {
+      FOS_TEST_MESSAGE("!y%s!! x %i over %i ids: !rmap!! %.2fms !m=>!! !gtrie!! %.2fms", labels[i],
+                       FOS_BENCH_HEAP_ROUNDS, FOS_BENCH_HEAP_BRANCHES * FOS_BENCH_HEAP_LEAVES, timings["map"][i],
+                       timings["trie"][i]);
+    }
+  }
+
+  FOS_RUN_TESTS( //
+      FOS_RUN_TEST(bench_heap_backends); //
+  )
+}; // namespace fhatos
+
+SETUP_AND_LOOP();
+
+
+#endif
@@ -0,0 +1,91 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef fhatos_bench_inst_hpp
+#define fhatos_bench_inst_hpp
+
+#define FOS_DEPLOY_ROUTER
+#define FOS_DEPLOY_SCHEDULER
+#define FOS_DEPLOY_PROCESSOR
+#define FOS_DEPLOY_MMADT_TYPE
+#define FOS_DEPLOY_MMADT_EXT_TYPE
+#define FOS_DEPLOY_FOS_TYPE
+#define FOS_DEPLOY_PARSER
+#define FOS_DEPLOY_SHARED_MEMORY /inst/#
+
+#include <chrono>
+#include <new>
+#include "../../../src/lang/obj.hpp"
+#include "../../../src/util/obj_helper.hpp"
+#include "../../test_fhatos.hpp"
+
+#define FOS_BENCH_DISPATCHES 2000
+
+////////////////////////////////////////////////////////
+/////////////////// ALLOCATION COUNTER /////////////////
+////////////////////////////////////////////////////////
+static std::atomic<size_t> FOS_BENCH_ALLOCATIONS{0};
+
+void *operator new(const std::size_t size) {
+  FOS_BENCH_ALLOCATIONS.fetch_add(1, std::memory_order_relaxed);
+  if(void *p = std::malloc(size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace fhatos {
+  void bench_dispatch(const string &code, const Obj_p &expected) {
+    const BCode_p bcode = OBJ_PARSER(code);
+    const Obj_p lhs = jnt(1);
+    FOS_TEST_OBJ_EQUAL(expected, bcode->apply(lhs)); // warm up (and verify)
+    const size_t insts = bcode->is_bcode() ? bcode->bcode_value()->size() : 1;
+    const size_t allocations_start = FOS_BENCH_ALLOCATIONS.load();
+    const auto start = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < FOS_BENCH_DISPATCHES; i++) {
+      const Obj_p result = bcode->apply(lhs);
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    const size_t allocations = FOS_BENCH_ALLOCATIONS.load() - allocations_start;
+    const double millis = std::chrono::duration<double, std::milli>(end - start).count();
+    FOS_TEST_MESSAGE("!b%s!! x %i: !g%.0f!! inst dispatches/sec (%.2fms) !m|!! !y%zu!! allocations per dispatch",
+                     code.c_str(), FOS_BENCH_DISPATCHES, (insts * FOS_BENCH_DISPATCHES) / (millis / 1000.0), millis,
+                     allocations / (insts * FOS_BENCH_DISPATCHES));
+  }
+
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  void bench_inst_dispatch() {
+    bench_dispatch("plus(2)", jnt(3));
+    bench_dispatch("plus(2).mult(3).plus(-6)", jnt(3));
+    bench_dispatch("plus(2).is(gt(0)).mult(2)", jnt(6));
+  }
+
+  FOS_RUN_TESTS( //
+      FOS_RUN_TEST(bench_inst_dispatch); //
+  )
+}; // namespace fhatos
+
+SETUP_AND_LOOP();
+
+
+#endif
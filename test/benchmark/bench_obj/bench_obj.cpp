@@ -0,0 +1,173 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef fhatos_bench_obj_hpp
+#define fhatos_bench_obj_hpp
+
+#define FOS_DEPLOY_ROUTER
+#define FOS_DEPLOY_SCHEDULER
+#define FOS_DEPLOY_PROCESSOR
+#define FOS_DEPLOY_MMADT_TYPE
+#define FOS_DEPLOY_MMADT_EXT_TYPE
+#define FOS_DEPLOY_FOS_TYPE
+#define FOS_DEPLOY_PARSER
+#define FOS_DEPLOY_SHARED_MEMORY /obj/#
+
+#include <chrono>
+#include <new>
+#include "../../../src/lang/obj.hpp"
+#include "../../../src/util/obj_helper.hpp"
+#include "../../test_fhatos.hpp"
+
+#define FOS_BENCH_REC_SIZE 256
+#define FOS_BENCH_ROUNDS 200
+#define FOS_BENCH_PIPELINE_RUNS 25
+
+////////////////////////////////////////////////////////
+/////////////////// ALLOCATION COUNTER /////////////////
+////////////////////////////////////////////////////////
+static std::atomic<size_t> FOS_BENCH_ALLOCATIONS{0};
+
+void *operator new(const std::size_t size) {
+  FOS_BENCH_ALLOCATIONS.fetch_add(1, std::memory_order_relaxed);
+  if(void *p = std::malloc(size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+namespace fhatos {
+  size_t count_allocations(const Runnable &runnable) {
+    const size_t start = FOS_BENCH_ALLOCATIONS.load();
+    runnable();
+    return FOS_BENCH_ALLOCATIONS.load() - start;
+  }
+
+  /// the pre-structural-hash behavior (kept here as the benchmark baseline)
+  struct objp_string_hash {
+    size_t operator()(const Obj_p &obj) const { return std::hash<std::string>{}(obj->toString()); }
+  };
+
+  template<typename HASH>
+  double time_rec_lookups(const List<Obj_p> &keys, const List<Obj_p> &probes, size_t *found) {
+    auto map = Obj::RecMap<HASH>();
+    for(size_t i = 0; i < keys.size(); i++) {
+      map.insert({keys.at(i), jnt(i)});
+    }
+    *found = 0;
+    const auto start = std::chrono::high_resolution_clock::now();
+    for(int round = 0; round < FOS_BENCH_ROUNDS; round++) {
+      for(const Obj_p &probe: probes) {
+        if(map.count(probe))
+          (*found)++;
+      }
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  void bench_rec_lookup(const Function<int, Obj_p> &key_maker, const char *label) {
+    List<Obj_p> keys;
+    List<Obj_p> probes;
+    for(int i = 0; i < FOS_BENCH_REC_SIZE; i++) {
+      keys.push_back(key_maker(i));
+      probes.push_back(key_maker(i)); // equal but not identical objs
+    }
+    size_t before_found = 0;
+    size_t after_found = 0;
+    const double before = time_rec_lookups<objp_string_hash>(keys, probes, &before_found);
+    const double after = time_rec_lookups<Obj::objp_hash>(keys, probes, &after_found);
+    FOS_TEST_MESSAGE("!y%s!! rec lookups [%i x %i]: !rtoString() hash!! %.2fms !m=>!! !gstructural hash!! %.2fms (%.1fx)",
+                     label, FOS_BENCH_REC_SIZE, FOS_BENCH_ROUNDS, before, after, before / (after > 0 ? after : 1));
+    TEST_ASSERT_EQUAL(FOS_BENCH_REC_SIZE * FOS_BENCH_ROUNDS, before_found);
+    TEST_ASSERT_EQUAL(FOS_BENCH_REC_SIZE * FOS_BENCH_ROUNDS, after_found);
+  }
+
+  void bench_rec_lookup_uri_keys() {
+    bench_rec_lookup([](const int i) { return vri(fURI("/a/b/c").extend(to_string(i))); }, "uri");
+  }
+
+  void bench_rec_lookup_str_keys() {
+    bench_rec_lookup([](const int i) { return str(string("key_").append(to_string(i))); }, "str");
+  }
+
+  void bench_rec_lookup_int_keys() {
+    bench_rec_lookup([](const int i) { return jnt(i); }, "int");
+  }
+
+  void bench_rec_lookup_lst_keys() {
+    bench_rec_lookup([](const int i) { return lst({jnt(i), str("x"), vri("/y")}); }, "lst");
+  }
+
+  void bench_small_value_allocations() {
+    // warm the interned value tables
+    jnt(0);
+    dool(true);
+    const size_t boxed = count_allocations([] {
+      for(int i = 0; i < 1000; i++) {
+        Obj::create(i % 100, OType::INT, INT_FURI);
+        Obj::create(i % 2 == 0, OType::BOOL, BOOL_FURI);
+      }
+    });
+    const size_t interned = count_allocations([] {
+      for(int i = 0; i < 1000; i++) {
+        jnt(i % 100);
+        dool(i % 2 == 0);
+        Obj::to_noobj();
+      }
+    });
+    FOS_TEST_MESSAGE("!y1000 x (int,bool)!! allocations: !rObj::create()!! %zu !m=>!! !ginterned!! %zu", boxed, interned);
+    TEST_ASSERT_EQUAL(0, interned);
+    TEST_ASSERT_LESS_THAN_INT(boxed, interned);
+  }
+
+  void bench_plus_mult_allocations() {
+    for(const auto &[code, expected]: List<Pair<string, Obj_p>>{{"1.plus(2).mult(3)", jnt(9)},
+                                                                 {"10.plus(2).mult(3).plus(-6)", jnt(30)},
+                                                                 {"1.5.plus(2.5).mult(2.0)", real(8.0f)}}) {
+      const BCode_p bcode = OBJ_PARSER(code);
+      FOS_TEST_OBJ_EQUAL(expected, BCODE_PROCESSOR(bcode)->objs_value(0)); // warm up (and verify)
+      const size_t allocations = count_allocations([bcode = bcode] {
+        for(int i = 0; i < FOS_BENCH_PIPELINE_RUNS; i++) {
+          BCODE_PROCESSOR(bcode);
+        }
+      });
+      FOS_TEST_MESSAGE("!b%s!! allocations per pipeline: !g%zu!!", code.c_str(), allocations / FOS_BENCH_PIPELINE_RUNS);
+    }
+  }
+
+  FOS_RUN_TESTS( //
+      FOS_RUN_TEST(bench_rec_lookup_uri_keys); //
+      FOS_RUN_TEST(bench_rec_lookup_str_keys); //
+      FOS_RUN_TEST(bench_rec_lookup_int_keys); //
+      FOS_RUN_TEST(bench_rec_lookup_lst_keys); //
+      FOS_RUN_TEST(bench_small_value_allocations); //
+      FOS_RUN_TEST(bench_plus_mult_allocations); //
+  )
+}; // namespace fhatos
+
+SETUP_AND_LOOP();
+
+
+#endif
@@ -0,0 +1,224 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef fhatos_bench_processor_hpp
+#define fhatos_bench_processor_hpp
+
+#define FOS_DEPLOY_ROUTER
+#define FOS_DEPLOY_SCHEDULER
+#define FOS_DEPLOY_PROCESSOR
+#define FOS_DEPLOY_MMADT_TYPE
+#define FOS_DEPLOY_MMADT_EXT_TYPE
+#define FOS_DEPLOY_FOS_TYPE
+#define FOS_DEPLOY_PARSER
+#define FOS_DEPLOY_SHARED_MEMORY /processor/#
+
+#include <chrono>
+#include "../../../src/lang/processor/processor.hpp"
+#include "../../test_fhatos.hpp"
+
+#define FOS_BENCH_PROCESSOR_OBJS 400
+#define FOS_BENCH_PROCESSOR_DISTINCT 4
+#define FOS_BENCH_PROCESSOR_RUNS 3
+
+namespace fhatos {
+  /// a stream of FOS_BENCH_PROCESSOR_OBJS ints with only FOS_BENCH_PROCESSOR_DISTINCT distinct values
+  string duplicate_stream(const string &suffix) {
+    string code = "{";
+    for(int i = 0; i < FOS_BENCH_PROCESSOR_OBJS; i++) {
+      code.append(to_string(i % FOS_BENCH_PROCESSOR_DISTINCT)).append(i < FOS_BENCH_PROCESSOR_OBJS - 1 ? "," : "}");
+    }
+    return code.append(suffix);
+  }
+
+  /// the executor benchmarks run their insts rather than the rewriter's folded constants
+  struct Unfolded {
+    Unfolded() { Rewriter::enable(REWRITE_FOLD, false); }
+    ~Unfolded() { Rewriter::enable(REWRITE_FOLD, true); }
+  };
+
+  /// the time to process the stream once its source inst has scattered it into monads
+  double time_processor(const string &code, const bool bulk, Objs_p *result, const bool batch = false,
+                        const uint8_t parallelism = 1) {
+    double total = 0;
+    for(int i = 0; i < FOS_BENCH_PROCESSOR_RUNS; i++) {
+      const ptr<Processor> processor = make_shared<Processor>(OBJ_PARSER(code), bulk, batch, parallelism);
+      processor->execute(1);
+      const auto start = std::chrono::high_resolution_clock::now();
+      *result = processor->to_objs();
+      const auto end = std::chrono::high_resolution_clock::now();
+      total += std::chrono::duration<double, std::milli>(end - start).count();
+    }
+    return total;
+  }
+
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  void bench_bulked_traversers() {
+    const Unfolded unfolded;
+    for(const char *suffix: {".plus(1).mult(2)", ".plus(1).mult(2).count()", ".plus(1).mult(2).sum()"}) {
+      const string code = duplicate_stream(suffix);
+      Objs_p unbulked;
+      Objs_p bulked;
+      const double unbulked_time = time_processor(code, false, &unbulked);
+      const double bulked_time = time_processor(code, true, &bulked);
+      TEST_ASSERT_EQUAL_INT(unbulked->objs_value()->size(), bulked->objs_value()->size());
+      FOS_TEST_MESSAGE("!b{%i objs}%s!! x %i: !runbulked!! %.2fms !m=>!! !gbulked!! %.2fms", FOS_BENCH_PROCESSOR_OBJS,
+                       suffix, FOS_BENCH_PROCESSOR_RUNS, unbulked_time, bulked_time);
+    }
+  }
+
+  /// a stream of FOS_BENCH_PROCESSOR_OBJS distinct reals (nothing for bulking to merge)
+  string real_stream(const string &suffix) {
+    string code = "{";
+    for(int i = 0; i < FOS_BENCH_PROCESSOR_OBJS; i++) {
+      code.append(to_string(i)).append(".5").append(i < FOS_BENCH_PROCESSOR_OBJS - 1 ? "," : "}");
+    }
+    return code.append(suffix);
+  }
+
+  void bench_batched_numerics() {
+    const Unfolded unfolded;
+    for(const char *suffix: {".plus(1.0).mult(2.0)", ".plus(1.0).mult(2.0).minus(0.5).is(gt(100.0))",
+                             ".plus(1.0).mult(2.0).is(gt(100.0)).sum()"}) {
+      const string code = real_stream(suffix);
+      Objs_p monads;
+      Objs_p batched;
+      const double monad_time = time_processor(code, false, &monads, false);
+      const double batch_time = time_processor(code, false, &batched, true);
+      TEST_ASSERT_EQUAL_INT(monads->objs_value()->size(), batched->objs_value()->size());
+      FOS_TEST_MESSAGE("!b{%i reals}%s!! x %i: !rmonads!! %.2fms !m=>!! !gbatched!! %.2fms", FOS_BENCH_PROCESSOR_OBJS,
+                       suffix, FOS_BENCH_PROCESSOR_RUNS, monad_time, batch_time);
+    }
+  }
+
+  void bench_parallel_scaling() {
+    const Unfolded unfolded;
+    FOS_TEST_MESSAGE("!b%i hardware threads!!", std::thread::hardware_concurrency());
+    for(const char *suffix: {".plus(1.0).mult(2.0).plus(3.0).mult(4.0).sum()"}) {
+      const string code = real_stream(suffix);
+      Objs_p serial;
+      const double serial_time = time_processor(code, false, &serial, false, 1);
+      FOS_TEST_MESSAGE("!b{%i reals}%s!! x %i: !y1 core!! %.2fms", FOS_BENCH_PROCESSOR_OBJS, suffix,
+                       FOS_BENCH_PROCESSOR_RUNS, serial_time);
+      for(const uint8_t cores: {2, 4, 8}) {
+        Objs_p parallel;
+        const double parallel_time = time_processor(code, false, &parallel, false, cores);
+        TEST_ASSERT_EQUAL_INT(serial->objs_value()->size(), parallel->objs_value()->size());
+        FOS_TEST_MESSAGE("!b{%i reals}%s!! x %i: !y%i cores!! %.2fms (!g%.2fx!!)", FOS_BENCH_PROCESSOR_OBJS, suffix,
+                         FOS_BENCH_PROCESSOR_RUNS, cores, parallel_time, serial_time / parallel_time);
+      }
+    }
+  }
+
+  /// the time until a consumer has its first result (a full evaluation vs. a streaming cursor)
+  void bench_first_result() {
+    const Unfolded unfolded;
+    for(const char *suffix: {".plus(1.0).mult(2.0).is(gt(100.0))", ".plus(1.0).mult(2.0).limit(1)"}) {
+      const string code = real_stream(suffix);
+      double eager_time = 0;
+      double streaming_time = 0;
+      for(int i = 0; i < FOS_BENCH_PROCESSOR_RUNS; i++) {
+        const ptr<Processor> eager = make_shared<Processor>(OBJ_PARSER(code));
+        eager->execute(1);
+        auto start = std::chrono::high_resolution_clock::now();
+        const Obj_p x = eager->to_objs()->objs_value()->front();
+        eager_time += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        const ptr<Processor> streaming = make_shared<Processor>(OBJ_PARSER(code));
+        streaming->execute(1);
+        start = std::chrono::high_resolution_clock::now();
+        const Obj_p y = *streaming->begin();
+        streaming_time +=
+            std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        TEST_ASSERT_TRUE(nullptr != y);
+      }
+      FOS_TEST_MESSAGE("!b{%i reals}%s!! x %i: first result !rto_objs()!! %.2fms !m=>!! !gcursor!! %.2fms",
+                       FOS_BENCH_PROCESSOR_OBJS, suffix, FOS_BENCH_PROCESSOR_RUNS, eager_time, streaming_time);
+    }
+  }
+
+  /// the time to rewrite and process a bcode with and without the optimization passes
+  void bench_rewrites() {
+    const List<ID> passes = {REWRITE_COLLAPSE, REWRITE_FOLD, REWRITE_PUSHDOWN, REWRITE_DEAD, REWRITE_FUSE};
+    const auto time = [&passes](const string &code, const bool optimized, Objs_p *result) {
+      for(const ID &pass: passes) {
+        Rewriter::enable(pass, optimized);
+      }
+      double total = 0;
+      for(int i = 0; i < FOS_BENCH_PROCESSOR_RUNS; i++) {
+        const BCode_p bcode = OBJ_PARSER(code);
+        const auto start = std::chrono::high_resolution_clock::now();
+        *result = Processor(bcode).to_objs();
+        total += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+      }
+      return total;
+    };
+    for(const char *suffix: {".plus(1.0).mult(2.0).plus(3.0).mult(4.0)", ".limit(400).plus(1.0).mult(2.0).plus(3.0).mult(4.0)",
+                             ".limit(400).plus(1.0).mult(2.0).is(gt(100.0)).count()"}) {
+      const string code = real_stream(suffix);
+      Objs_p plain;
+      Objs_p optimized;
+      const double plain_time = time(code, false, &plain);
+      const double optimized_time = time(code, true, &optimized);
+      TEST_ASSERT_EQUAL_INT(plain->objs_value()->size(), optimized->objs_value()->size());
+      FOS_TEST_MESSAGE("!b{%i reals}%s!! x %i: !runoptimized!! %.2fms !m=>!! !goptimized!! %.2fms",
+                       FOS_BENCH_PROCESSOR_OBJS, suffix, FOS_BENCH_PROCESSOR_RUNS, plain_time, optimized_time);
+    }
+  }
+
+  /// the time to apply a loop body to an obj over and over (interpreted vs. a compiled closure)
+  void bench_closures() {
+    for(const char *body: {"plus(1).mult(2)", "plus(1.0).mult(2.0).minus(0.5).plus(3.0)"}) {
+      const BCode_p bcode = OBJ_PARSER(body);
+      Closure closure(bcode);
+      const Obj_p lhs = bcode->bcode_value()->front()->inst_args()->arg(0)->is_real() ? real(1.5) : jnt(1);
+      auto start = std::chrono::high_resolution_clock::now();
+      Obj_p interpreted;
+      for(int i = 0; i < FOS_BENCH_PROCESSOR_OBJS; i++) {
+        interpreted = bcode->apply(lhs);
+      }
+      const double interpreted_time =
+          std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+      start = std::chrono::high_resolution_clock::now();
+      Obj_p compiled;
+      for(int i = 0; i < FOS_BENCH_PROCESSOR_OBJS; i++) {
+        compiled = closure.apply(lhs);
+      }
+      const double compiled_time =
+          std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+      FOS_TEST_OBJ_EQUAL(interpreted, compiled);
+      FOS_TEST_MESSAGE("!b%s!! x %i: !rinterpreted!! %.2fms !m=>!! !gclosure!! %.2fms", body, FOS_BENCH_PROCESSOR_OBJS,
+                       interpreted_time, compiled_time);
+    }
+  }
+
+  FOS_RUN_TESTS( //
+      FOS_RUN_TEST(bench_bulked_traversers); //
+      FOS_RUN_TEST(bench_batched_numerics); //
+      FOS_RUN_TEST(bench_parallel_scaling); //
+      FOS_RUN_TEST(bench_first_result); //
+      FOS_RUN_TEST(bench_rewrites); //
+      FOS_RUN_TEST(bench_closures); //
+  )
+}; // namespace fhatos
+
+SETUP_AND_LOOP();
+
+
+#endif
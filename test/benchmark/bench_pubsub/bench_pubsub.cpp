@@ -0,0 +1,131 @@
+/*******************************************************************************
+  FhatOS: A Distributed Operating System
+  Copyright (c) 2024 PhaseShift Studio, LLC
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Affero General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU Affero General Public License for more details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef fhatos_bench_pubsub_hpp
+#define fhatos_bench_pubsub_hpp
+
+#define FOS_DEPLOY_ROUTER
+#define FOS_DEPLOY_SCHEDULER
+#define FOS_DEPLOY_MMADT_TYPE
+#define FOS_DEPLOY_FOS_TYPE
+#define FOS_DEPLOY_PARSER
+#define FOS_DEPLOY_SHARED_MEMORY /pubsub/#
+
+#include <chrono>
+#include "../../../src/structure/pubsub.hpp"
+#include "../../test_fhatos.hpp"
+
+#define FOS_BENCH_SUBSCRIPTIONS 10000
+#define FOS_BENCH_PUBLISHES 25
+
+namespace fhatos {
+  /// the pre-topic-tree behavior (kept here as the benchmark baseline)
+  class LinearPost final : public Mailbox {
+  public:
+    List<Subscription_p> subscriptions_;
+
+    void receive(const Message_p &message, bool) const {
+      for(const Subscription_p &sub: this->subscriptions_) {
+        if(message->target()->bimatches(*sub->pattern()))
+          this->recv_mail(Mail(sub, message));
+      }
+    }
+  };
+
+  size_t drain(const Mailbox &mailbox) {
+    size_t count = 0;
+    while(mailbox.next_mail().has_value())
+      count++;
+    return count;
+  }
+
+  template<typename POST>
+  double time_publishes(const POST &post, const List<Message_p> &messages, size_t *delivered) {
+    const auto start = std::chrono::high_resolution_clock::now();
+    for(const Message_p &message: messages) {
+      post.receive(message, false);
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    *delivered = drain(post);
+    return std::chrono::duration<double, std::milli>(end - start).count();
+  }
+
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  //////////////////////////////////////////////////////////
+  void bench_publish_10k_subscriptions() {
+    const ID_p source = id_p("/pubsub/source");
+    const Obj_p on_recv = Obj::to_bcode();
+    LocalPost tree_post;
+    LinearPost linear_post;
+    for(int i = 0; i < FOS_BENCH_SUBSCRIPTIONS; i++) {
+      // a mix of exact, single-level (+), and multi-level (#) subscriptions
+      const string pattern = 0 == i % 3   ? string("/pubsub/a").append(to_string(i)).append("/x")
+                             : 1 == i % 3 ? string("/pubsub/+/y").append(to_string(i))
+                                          : string("/pubsub/h").append(to_string(i)).append("/#");
+      const auto sub = make_shared<Subscription>(source, p_p(pattern.c_str()), on_recv);
+      tree_post.subscribe(sub, false);
+      linear_post.subscriptions_.push_back(sub);
+    }
+    TEST_ASSERT_EQUAL(FOS_BENCH_SUBSCRIPTIONS, tree_post.subscriptions_->size());
+    List<Message_p> messages;
+    for(int i = 0; i < FOS_BENCH_PUBLISHES; i++) {
+      const int k = (i * 97) % FOS_BENCH_SUBSCRIPTIONS;
+      const string target = 0 == k % 3   ? string("/pubsub/a").append(to_string(k)).append("/x")
+                            : 1 == k % 3 ? string("/pubsub/z").append(to_string(k)).append("/y").append(to_string(k))
+                                         : string("/pubsub/h").append(to_string(k)).append("/deep/er");
+      messages.push_back(Message::create(id_p(target.c_str()), jnt(i), false));
+    }
+    size_t linear_delivered = 0;
+    size_t tree_delivered = 0;
+    const double linear = time_publishes(linear_post, messages, &linear_delivered);
+    const double tree = time_publishes(tree_post, messages, &tree_delivered);
+    FOS_TEST_MESSAGE("!y%i publishes x %i subscriptions!!: !rlinear scan!! %.2fms !m=>!! !gtopic tree!! %.2fms (%.1fx)",
+                     FOS_BENCH_PUBLISHES, FOS_BENCH_SUBSCRIPTIONS, linear, tree, linear / (tree > 0 ? tree : 1));
+    TEST_ASSERT_EQUAL(FOS_BENCH_PUBLISHES, linear_delivered);
+    TEST_ASSERT_EQUAL(linear_delivered, tree_delivered);
+  }
+
+  void bench_unsubscribe_10k_subscriptions() {
+    const ID_p source = id_p("/pubsub/source");
+    const Obj_p on_recv = Obj::to_bcode();
+    LocalPost post;
+    for(int i = 0; i < FOS_BENCH_SUBSCRIPTIONS; i++) {
+      const string pattern = string("/pubsub/u/").append(to_string(i));
+      post.subscribe(make_shared<Subscription>(source, p_p(pattern.c_str()), on_recv), false);
+    }
+    const auto start = std::chrono::high_resolution_clock::now();
+    for(int i = 0; i < FOS_BENCH_SUBSCRIPTIONS; i += 2) {
+      post.unsubscribe(*source, Pattern(string("/pubsub/u/").append(to_string(i))), false);
+    }
+    const auto end = std::chrono::high_resolution_clock::now();
+    FOS_TEST_MESSAGE("!y%i unsubscribes!! from %i subscriptions: !gtopic tree!! %.2fms", FOS_BENCH_SUBSCRIPTIONS / 2,
+                     FOS_BENCH_SUBSCRIPTIONS, std::chrono::duration<double, std::milli>(end - start).count());
+    TEST_ASSERT_EQUAL(FOS_BENCH_SUBSCRIPTIONS / 2, post.subscriptions_->size());
+  }
+
+  FOS_RUN_TESTS( //
+      FOS_RUN_TEST(bench_publish_10k_subscriptions); //
+      FOS_RUN_TEST(bench_unsubscribe_10k_subscriptions); //
+  )
+}; // namespace fhatos
+
+SETUP_AND_LOOP();
+
+
+#endif
@@ -178,6 +178,55 @@ namespace fhatos {
     FOS_TEST_ERROR("10.()[plus(*<0>).plus(*<1>)]");
   }
 
+  void test_inst_cache() {
+    Compiler::inst_cache_clear();
+    PROCESS("/compiler/cached -> |/compiler/cached?int<=int()[plus(1)]");
+    FOS_TEST_OBJ_EQUAL(jnt(2), PROCESS("1./compiler/cached()"));
+    const FOS_INT_TYPE hits = Compiler::inst_cache_stats()->rec_get("hits")->int_value();
+    FOS_TEST_OBJ_EQUAL(jnt(3), PROCESS("2./compiler/cached()"));
+    FOS_TEST_OBJ_EQUAL(jnt(4), PROCESS("3./compiler/cached()"));
+    TEST_ASSERT_GREATER_THAN_INT(hits, Compiler::inst_cache_stats()->rec_get("hits")->int_value());
+    // redefining the inst invalidates the cache
+    const FOS_INT_TYPE invalidations = Compiler::inst_cache_stats()->rec_get("invalidations")->int_value();
+    PROCESS("/compiler/cached -> |/compiler/cached?int<=int()[mult(10)]");
+    TEST_ASSERT_GREATER_THAN_INT(invalidations, Compiler::inst_cache_stats()->rec_get("invalidations")->int_value());
+    FOS_TEST_OBJ_EQUAL(jnt(20), PROCESS("2./compiler/cached()"));
+    // value-dependent domains are re-checked on a hit
+    PROCESS("/compiler/pos -> |/compiler/pos?int<=/compiler/nat()[plus(100)]");
+    FOS_TEST_OBJ_EQUAL(jnt(101), PROCESS("1./compiler/pos()"));
+    FOS_TEST_OBJ_EQUAL(jnt(102), PROCESS("2./compiler/pos()"));
+    FOS_TEST_ERROR("-2./compiler/pos()");
+    TEST_ASSERT_EQUAL_INT(4, Compiler::inst_cache_stats()->rec_value()->size());
+  }
+
+  void test_type_cache() {
+    Compiler::type_cache_clear();
+    const Compiler compiler = Compiler(false);
+    PROCESS("/compiler/even -> |/compiler/even?int<=int()[is(mod(2).eq(0))]");
+    FOS_TEST_COMPILER_TRUE(jnt(4), ID("/compiler/even"), compiler.type_check);
+    const FOS_INT_TYPE hits = Compiler::type_cache_stats()->rec_get("hits")->int_value();
+    FOS_TEST_COMPILER_TRUE(jnt(4), ID("/compiler/even"), compiler.type_check);
+    FOS_TEST_COMPILER_FALSE(jnt(5), ID("/compiler/even"), compiler.type_check);
+    FOS_TEST_COMPILER_FALSE(jnt(5), ID("/compiler/even"), compiler.type_check);
+    TEST_ASSERT_GREATER_THAN_INT(hits, Compiler::type_cache_stats()->rec_get("hits")->int_value());
+    // a failed check still raises its error
+    FOS_TEST_ERROR("5./compiler/even()");
+    // redefining the type invalidates its checks
+    const FOS_INT_TYPE invalidations = Compiler::type_cache_stats()->rec_get("invalidations")->int_value();
+    PROCESS("/compiler/even -> |/compiler/even?int<=int()[is(mod(2).eq(1))]");
+    TEST_ASSERT_GREATER_THAN_INT(invalidations, Compiler::type_cache_stats()->rec_get("invalidations")->int_value());
+    FOS_TEST_COMPILER_FALSE(jnt(4), ID("/compiler/even"), compiler.type_check);
+    FOS_TEST_COMPILER_TRUE(jnt(5), ID("/compiler/even"), compiler.type_check);
+    // typed recs are built from the cached definition
+    PROCESS("/compiler/account -> |[owner?str=>else('fhat'), balance?int=>else(0)]");
+    for(int i = 0; i < 3; i++) {
+      FOS_TEST_OBJ_EQUAL(rec({{"owner?str",str("fhat")},{"balance?int",jnt(10)}},id_p("/compiler/account")),
+                         PROCESS("/compiler/account[[balance=>10]]"));
+    }
+    FOS_TEST_ERROR("/compiler/account[[balance=>'ten']]");
+    TEST_ASSERT_GREATER_THAN_INT(0, Compiler::type_cache_stats()->rec_get("definitions")->int_value());
+  }
+
   FOS_RUN_TESTS( //
       FOS_RUN_TEST(test_type_check_base_types); //
       FOS_RUN_TEST(test_type_check_derived_mono_types); //
@@ -187,6 +236,8 @@ namespace fhatos {
       FOS_RUN_TEST(test_inst_resolution); //
       FOS_RUN_TEST(test_derived_type_inst_resolution); //
       FOS_RUN_TEST(test_anonymous_inst); //
+      FOS_RUN_TEST(test_inst_cache); //
+      FOS_RUN_TEST(test_type_cache); //
       )
 } // namespace fhatos
 
@@ -441,6 +441,45 @@ namespace fhatos {
     //
   }
 
+  void test_parse_and_plan_cache() {
+    LRUCache<string, int> lru(2);
+    lru.put("a", 1, 0);
+    lru.put("b", 2, 0);
+    TEST_ASSERT_EQUAL_INT(1, lru.get("a", 0).value());
+    lru.put("c", 3, 0);
+    TEST_ASSERT_FALSE(lru.get("b", 0).has_value());
+    TEST_ASSERT_FALSE(lru.get("a", 1).has_value());
+    TEST_ASSERT_EQUAL_INT(1, lru.evictions.load());
+    ///////////////////// parses
+    const long hits = mmadt::Parser::parses()->hits.load();
+    const Obj_p a = OBJ_PARSER("1.plus(2).mult([a=>3])");
+    const Obj_p b = OBJ_PARSER("1.plus(2).mult([a=>3])");
+    TEST_ASSERT_EQUAL_INT(hits + 1, mmadt::Parser::parses()->hits.load());
+    FOS_TEST_OBJ_EQUAL(a, b);
+    // each parse is the caller's own
+    TEST_ASSERT_TRUE(a.get() != b.get());
+    // typed values are checked on every parse
+    const size_t size = mmadt::Parser::parses()->size();
+    TEST_ASSERT_TRUE(OBJ_PARSER("/abc/nat[5]")->tid->equals(ID("/abc/nat")));
+    TEST_ASSERT_EQUAL_INT(size, mmadt::Parser::parses()->size());
+    ///////////////////// plans
+    const long plan_hits = Processor::plans()->hits.load();
+    const Objs_p planned = Processor::compute("{1,2,3}.plus(1).count()");
+    const Objs_p replayed = Processor::compute("{1,2,3}.plus(1).count()");
+    FOS_TEST_OBJ_EQUAL(jnt(3), replayed->objs_value()->front());
+    FOS_TEST_OBJ_EQUAL(planned, replayed);
+    TEST_ASSERT_EQUAL_INT(plan_hits + 1, Processor::plans()->hits.load());
+    // rewrite toggles replan
+    Rewriter::enable(REWRITE_FOLD, false);
+    const Objs_p replanned = Processor::compute("{1,2,3}.plus(1).count()");
+    Rewriter::enable(REWRITE_FOLD, true);
+    FOS_TEST_OBJ_EQUAL(planned, replanned);
+    TEST_ASSERT_EQUAL_INT(plan_hits + 1, Processor::plans()->hits.load());
+    const Rec_p stats = mmadt::Parser::cache_stats();
+    TEST_ASSERT_TRUE(stats->rec_get("parses")->rec_get("hits")->int_value() > 0);
+    TEST_ASSERT_TRUE(stats->rec_get("plans")->rec_get("hits")->int_value() > 0);
+  }
+
   FOS_RUN_TESTS( //
       FOS_RUN_TEST(test_comment_parsing); //
       FOS_RUN_TEST(test_tracker); //
@@ -474,6 +513,7 @@ namespace fhatos {
       FOS_RUN_TEST(test_apply_mono_parsing); //
       FOS_RUN_TEST(test_apply_poly_parsing); //
       FOS_RUN_TEST(test_is_predicate_parsing); //
+      FOS_RUN_TEST(test_parse_and_plan_cache); //
   )
 } // namespace fhatos
 
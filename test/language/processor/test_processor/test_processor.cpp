@@ -31,6 +31,12 @@ namespace fhatos {
   //////////////////////////////////////////////////////////
   using P = fhatos::Processor;
 
+  /// the executor tests run their insts rather than the rewriter's folded constants
+  struct Unfolded {
+    Unfolded() { Rewriter::enable(REWRITE_FOLD, false); }
+    ~Unfolded() { Rewriter::enable(REWRITE_FOLD, true); }
+  };
+
   void test_monad_set() {
     LOG(INFO, "creating processor\n");
     const ptr<Processor> processor = make_shared<Processor>(__(jnt(14)));
@@ -80,8 +86,342 @@ namespace fhatos {
     TEST_ASSERT_TRUE(mset.empty());
   }
 
+  void test_bulked_processor() {
+    const Unfolded unfolded;
+    for(const char *code: {"{1,1,2,1,2,2,2}.plus(1)", "{1,1,2,1,2,2,2}.plus(1).count()", "{1,1,2,1,2,2,2}.mult(2).sum()",
+                           "{1.5,1.5,2.0}.sum()", "{'a','a','b'}.count()", "{'a','a','b'}.sum()"}) {
+      const Objs_p unbulked = Processor::compute(OBJ_PARSER(code), false);
+      const Objs_p bulked = Processor::compute(OBJ_PARSER(code), true);
+      // bulking merges equal monads so traversers may halt in a different order
+      TEST_ASSERT_EQUAL_INT(unbulked->objs_value()->size(), bulked->objs_value()->size());
+      for(const Obj_p &obj: *unbulked->objs_value()) {
+        const auto occurrences = [&obj](const Objs_p &objs) {
+          return std::count_if(objs->objs_value()->begin(), objs->objs_value()->end(),
+                               [&obj](const Obj_p &o) { return o->equals(*obj); });
+        };
+        TEST_ASSERT_EQUAL_INT(occurrences(unbulked), occurrences(bulked));
+      }
+    }
+    const ptr<Processor> processor = make_shared<Processor>(OBJ_PARSER("{1,1,1,2}.plus(1)"), true);
+    const auto [obj, bulk] = processor->next_bulked();
+    FOS_TEST_OBJ_EQUAL(jnt(2), obj);
+    TEST_ASSERT_EQUAL_INT(3, bulk);
+  }
+
+  void test_batched_processor() {
+    const Unfolded unfolded;
+    for(const char *code: {"{1,2,3,4,5,6}.plus(2).mult(3).minus(1).is(gt(10))", "{1.5,2.5,3.5}.mult(2.0).plus(0.5).is(lte(6.0))",
+                           "{1,2,3,4,5}.plus(1).is(gt(2)).count()", "{1,1,2,2,3}.mult(2).is(eq(4)).sum()",
+                           "{4,8,12}.div(4).plus('a'.count())"}) {
+      for(const bool bulk: {false, true}) {
+        const Objs_p monads = Processor::compute(OBJ_PARSER(code), bulk, false);
+        const Objs_p batched = Processor::compute(OBJ_PARSER(code), bulk, true);
+        // batching runs each column through its steps before the next column so traversers may halt in a different order
+        TEST_ASSERT_EQUAL_INT(monads->objs_value()->size(), batched->objs_value()->size());
+        for(const Obj_p &obj: *monads->objs_value()) {
+          const auto occurrences = [&obj](const Objs_p &objs) {
+            return std::count_if(objs->objs_value()->begin(), objs->objs_value()->end(),
+                                 [&obj](const Obj_p &o) { return o->equals(*obj); });
+          };
+          TEST_ASSERT_EQUAL_INT(occurrences(monads), occurrences(batched));
+        }
+      }
+    }
+    ///////////////////// kernels
+    List<FOS_INT_TYPE> values = {1, 5, 2, 7, 3};
+    List<long> bulks = {1, 2, 3, 4, 5};
+    Batch::apply<FOS_INT_TYPE>({BatchOp::MULT, false, jnt(10)}, &values, &bulks);
+    Batch::apply<FOS_INT_TYPE>({BatchOp::GTE, true, jnt(30)}, &values, &bulks);
+    TEST_ASSERT_EQUAL_INT(3, values.size());
+    TEST_ASSERT_EQUAL_INT(50, values.at(0));
+    TEST_ASSERT_EQUAL_INT(70, values.at(1));
+    TEST_ASSERT_EQUAL_INT(30, values.at(2));
+    TEST_ASSERT_EQUAL_INT(2, bulks.at(0));
+    TEST_ASSERT_EQUAL_INT(4, bulks.at(1));
+    TEST_ASSERT_EQUAL_INT(5, bulks.at(2));
+    TEST_ASSERT_FALSE(Batch::step(OBJ_PARSER("div(0)"), OType::INT).has_value());
+    TEST_ASSERT_FALSE(Batch::step(OBJ_PARSER("plus(1.5)"), OType::INT).has_value());
+    TEST_ASSERT_TRUE(Batch::step(OBJ_PARSER("is(lt(1.5))"), OType::REAL).has_value());
+  }
+
+  void test_parallel_processor() {
+    const Unfolded unfolded;
+    string stream = "{";
+    for(int i = 0; i < 64; i++) {
+      stream.append(to_string(i % 16)).append(i < 63 ? "," : "}");
+    }
+    for(const string &suffix: {".plus(1).mult(2)", ".plus(1).mult(2).count()", ".mult(2).sum().plus(1)",
+                               ".is(gt(8)).count()", ".plus(1).is(lt(10))"}) {
+      const string code = stream + suffix;
+      for(const bool bulk: {false, true}) {
+        const Objs_p serial = Processor::compute(OBJ_PARSER(code), bulk, false, 1);
+        for(const uint8_t parallelism: {2, 4}) {
+          // workers halt traversers in a nondeterministic order
+          const Objs_p parallel = Processor::compute(OBJ_PARSER(code), bulk, false, parallelism);
+          TEST_ASSERT_EQUAL_INT(serial->objs_value()->size(), parallel->objs_value()->size());
+          for(const Obj_p &obj: *serial->objs_value()) {
+            const auto occurrences = [&obj](const Objs_p &objs) {
+              return std::count_if(objs->objs_value()->begin(), objs->objs_value()->end(),
+                                   [&obj](const Obj_p &o) { return o->equals(*obj); });
+            };
+            TEST_ASSERT_EQUAL_INT(occurrences(serial), occurrences(parallel));
+          }
+        }
+      }
+    }
+    // a worker's error is rethrown on the calling thread
+    FOS_TEST_EXCEPTION_CXX(Processor::compute(OBJ_PARSER("{1,2,3,4}.plus(1).plus('a')"), false, false, 4));
+  }
+
+  void test_streaming_processor() {
+    const Unfolded unfolded;
+    const ptr<Processor> processor = make_shared<Processor>(OBJ_PARSER("{1,2,3}.plus(1)"));
+    List<Obj_p> results;
+    for(const Obj_p &obj: *processor) {
+      results.push_back(obj);
+    }
+    TEST_ASSERT_EQUAL_INT(3, results.size());
+    FOS_TEST_OBJ_EQUAL(jnt(2), results.at(0));
+    FOS_TEST_OBJ_EQUAL(jnt(3), results.at(1));
+    FOS_TEST_OBJ_EQUAL(jnt(4), results.at(2));
+    ///////////////////// limit/take
+    TEST_ASSERT_EQUAL_INT(2, Processor::compute(OBJ_PARSER("{1,2,3,4,5}.plus(1).limit(2)"))->objs_value()->size());
+    TEST_ASSERT_EQUAL_INT(0, Processor::compute(OBJ_PARSER("{1,2,3,4,5}.take(0)"))->objs_value()->size());
+    FOS_TEST_OBJ_EQUAL(jnt(3),
+                       Processor::compute(OBJ_PARSER("{1,2,3,4,5}.plus(1).limit(3).count()"))->objs_value()->front());
+    const Objs_p bulked = Processor::compute(OBJ_PARSER("{1,1,1,2}.limit(2)"), true);
+    TEST_ASSERT_EQUAL_INT(2, bulked->objs_value()->size());
+    FOS_TEST_OBJ_EQUAL(jnt(1), bulked->objs_value()->at(0));
+    FOS_TEST_OBJ_EQUAL(jnt(1), bulked->objs_value()->at(1));
+    // once the limit is reached the upstream monads are dropped (1 would fail at minus as a dead monad)
+    const ptr<Processor> limited = make_shared<Processor>(OBJ_PARSER("{3,2,1}.is(gt(1)).minus(1).limit(2)"));
+    const Obj_p limited_1 = limited->next();
+    const Obj_p limited_2 = limited->next();
+    FOS_TEST_OBJ_EQUAL(jnt(2), limited_1);
+    FOS_TEST_OBJ_EQUAL(jnt(1), limited_2);
+    TEST_ASSERT_TRUE(nullptr == limited->next());
+    ///////////////////// {0,1} range
+    const BCode_p single =
+        Obj::to_bcode(OBJ_PARSER("{1,2,3}.plus(1)")->bcode_value(), id_p(BCODE_FURI->query({{FOS_RNG_COEF, "0,1"}})));
+    const Objs_p first = Processor(single).to_objs();
+    TEST_ASSERT_EQUAL_INT(1, first->objs_value()->size());
+    FOS_TEST_OBJ_EQUAL(jnt(2), first->objs_value()->front());
+  }
+
+  void test_combined_barriers() {
+    const Unfolded unfolded;
+    for(const bool bulk: {false, true}) {
+      for(const uint8_t parallelism: {1, 4}) {
+        const auto compute = [bulk, parallelism](const string &code) {
+          return Processor::compute(OBJ_PARSER(code), bulk, false, parallelism)->objs_value()->front();
+        };
+        FOS_TEST_OBJ_EQUAL(jnt(18), compute("{1,1,2,2,3,3}.plus(1).sum()"));
+        FOS_TEST_OBJ_EQUAL(jnt(576), compute("{1,1,2,2,3,3}.plus(1).prod()"));
+        FOS_TEST_OBJ_EQUAL(jnt(6), compute("{1,1,2,2,3,3}.plus(1).count()"));
+        FOS_TEST_OBJ_EQUAL(jnt(2), compute("{1,1,2,2,3,3}.plus(1).min()"));
+        FOS_TEST_OBJ_EQUAL(jnt(4), compute("{1,1,2,2,3,3}.plus(1).max()"));
+        FOS_TEST_OBJ_EQUAL(real(3.0), compute("{1,1,2,2,3,3}.plus(1).mean()"));
+        FOS_TEST_OBJ_EQUAL(real(4.5), compute("{1.5,1.5,0.5,1.0}.sum()"));
+        // workers concatenate strs in the order they gather them
+        string concatenated = compute("{'a','a','b'}.sum()")->str_value();
+        std::sort(concatenated.begin(), concatenated.end());
+        TEST_ASSERT_EQUAL_STRING("aab", concatenated.c_str());
+        FOS_TEST_OBJ_EQUAL(jnt(11), compute("{1,2,3,4}.sum().plus(1)"));
+      }
+    }
+    // outside a processor the gather insts fold their objs
+    FOS_TEST_OBJ_EQUAL(real(2.5), Combiner::fold("mean", Obj::to_objs({jnt(1), jnt(2), jnt(3), jnt(4)})));
+    FOS_TEST_OBJ_EQUAL(noobj(), Combiner::fold("sum", Obj::to_objs()));
+    FOS_TEST_OBJ_EQUAL(jnt(0), Combiner::fold("count", Obj::to_objs()));
+    // partial aggregates merge (as the workers' do)
+    const Combiner_p a = Combiner::create("sum");
+    const Combiner_p b = Combiner::create("sum");
+    a->accumulate(jnt(3), 2);
+    b->accumulate(jnt(4), 1);
+    a->merge(*b);
+    FOS_TEST_OBJ_EQUAL(jnt(10), a->finish());
+    FOS_TEST_EXCEPTION_CXX(Combiner::fold("mean", Obj::to_objs({str("a")})));
+  }
+
+  void test_profiled_processor() {
+    const Unfolded unfolded;
+    for(const uint8_t parallelism: {1, 4}) {
+      const Objs_p profiled =
+          Processor::compute(OBJ_PARSER("{1,2,3,4}.plus(1).is(gt(2)).profile()"), false, false, parallelism);
+      TEST_ASSERT_EQUAL_INT(1, profiled->objs_value()->size());
+      const Rec_p profile = profiled->objs_value()->front();
+      TEST_ASSERT_EQUAL_INT(3, profile->rec_get("result")->lst_value()->size());
+      const Lst_p insts = profile->rec_get("insts");
+      TEST_ASSERT_EQUAL_INT(3, insts->lst_value()->size()); // the terminal profile() isn't profiled
+      const Rec_p plus = insts->lst_value()->at(1);
+      FOS_TEST_OBJ_EQUAL(jnt(4), plus->rec_get("in"));
+      FOS_TEST_OBJ_EQUAL(jnt(4), plus->rec_get("out"));
+      TEST_ASSERT_GREATER_THAN_INT(0, plus->rec_get("allocations")->int_value());
+      const Rec_p is = insts->lst_value()->at(2);
+      FOS_TEST_OBJ_EQUAL(jnt(4), is->rec_get("in"));
+      FOS_TEST_OBJ_EQUAL(jnt(3), is->rec_get("out"));
+    }
+    // a barrier counts its gathered objs in and its result out
+    const Rec_p counted = Processor::compute(OBJ_PARSER("{1,2,3}.count().profile()"))->objs_value()->front();
+    const Rec_p count = counted->rec_get("insts")->lst_value()->at(1);
+    FOS_TEST_OBJ_EQUAL(jnt(3), count->rec_get("in"));
+    FOS_TEST_OBJ_EQUAL(jnt(1), count->rec_get("out"));
+    FOS_TEST_OBJ_EQUAL(jnt(3), counted->rec_get("result")->lst_value()->front());
+    // sampling
+    const uint32_t rate = PROFILE_SAMPLING.load();
+    PROFILE_SAMPLING = 1;
+    Profiler::singleton()->reset();
+    Processor::compute(OBJ_PARSER("{1,2,3}.plus(1).mult(2)"));
+    const Rec_p sampled = Profiler::singleton()->to_rec()->rec_get("insts");
+    TEST_ASSERT_GREATER_THAN_INT(1, sampled->rec_value()->size());
+    PROFILE_SAMPLING = rate;
+  }
+
+  void test_rewritten_processor() {
+    // the rewritten insts' ops (and the ops they fuse)
+    const Function<BCode_p, string> fused_ops = [&fused_ops](const BCode_p &bcode) {
+      string ops;
+      for(const Inst_p &inst: *bcode->bcode_value()) {
+        ops.append(ops.empty() ? "" : ".").append(inst->inst_op());
+        if("fuse" == inst->inst_op())
+          ops.append("(").append(fused_ops(inst->inst_args()->arg(0))).append(")");
+      }
+      return ops;
+    };
+    const auto ops = [&fused_ops](const string &code, const bool fuse = true) {
+      return fused_ops(Processor::rewriter(fuse).apply(OBJ_PARSER(code)));
+    };
+    const auto compute = [](const string &code) { return Processor::compute(OBJ_PARSER(code))->objs_value(); };
+    ///////////////////// constant folding
+    TEST_ASSERT_EQUAL_STRING("start", ops("5.plus(1).mult(2)").c_str());
+    FOS_TEST_OBJ_EQUAL(jnt(12), compute("5.plus(1).mult(2)")->front());
+    TEST_ASSERT_EQUAL_STRING("start", ops("{1,2,3,4}.is(gt(1)).minus(1)").c_str());
+    TEST_ASSERT_EQUAL_INT(3, compute("{1,2,3,4}.is(gt(1)).minus(1)")->size());
+    TEST_ASSERT_EQUAL_STRING("start.count.plus", ops("{1,2}.plus(1).count().plus(1)").c_str());
+    FOS_TEST_OBJ_EQUAL(jnt(3), compute("{1,2}.plus(1).count().plus(1)")->front());
+    ///////////////////// dead insts
+    TEST_ASSERT_EQUAL_STRING("start.limit.is", ops("{1,2}.limit(2).is(false).plus(1)").c_str());
+    TEST_ASSERT_EQUAL_STRING("start.limit.is.count", ops("{1,2}.limit(2).is(false).plus(1).count()").c_str());
+    FOS_TEST_OBJ_EQUAL(jnt(0), compute("{1,2}.limit(2).is(false).plus(1).count()")->front());
+    TEST_ASSERT_EQUAL_INT(0, compute("{1,2}.is(false).plus(1)")->size());
+    TEST_ASSERT_EQUAL_STRING("start.limit.plus", ops("{1,2}.limit(2).is(true).plus(1)").c_str());
+    ///////////////////// filter pushdown (into a fuse)
+    TEST_ASSERT_EQUAL_STRING("start.limit.fuse(is.plus)", ops("{1,2,3}.limit(3).plus(2).is(gt(3))").c_str());
+    // unfused, filtered objs would be dead monads at the map
+    TEST_ASSERT_EQUAL_STRING("start.limit.plus.is", ops("{1,2,3}.limit(3).plus(2).is(gt(3))", false).c_str());
+    const auto pushed = compute("{1,2,3}.limit(3).plus(2).is(gt(3))");
+    TEST_ASSERT_EQUAL_INT(2, pushed->size());
+    FOS_TEST_OBJ_EQUAL(jnt(4), pushed->at(0));
+    FOS_TEST_OBJ_EQUAL(jnt(5), pushed->at(1));
+    TEST_ASSERT_EQUAL_STRING("start.limit.fuse(is.mult)", ops("{-3,3,4}.limit(3).mult(2).is(lt(-5))").c_str());
+    const auto scaled = compute("{-3,3,4}.limit(3).mult(2).is(lt(-5))");
+    TEST_ASSERT_EQUAL_INT(1, scaled->size());
+    FOS_TEST_OBJ_EQUAL(jnt(-6), scaled->front());
+    // reals aren't shifted (rounding)
+    TEST_ASSERT_EQUAL_STRING("start.limit.fuse(plus.is)", ops("{1.5,2.5}.limit(2).plus(1.0).is(gt(2.0))").c_str());
+    ///////////////////// map fusion
+    TEST_ASSERT_EQUAL_STRING("start.limit.fuse(plus.mult.minus)",
+                             ops("{1,2,3}.limit(3).plus(1).mult(2).minus(3)").c_str());
+    const auto fused = compute("{1,2,3}.limit(3).plus(1).mult(2).minus(3)");
+    TEST_ASSERT_EQUAL_INT(3, fused->size());
+    FOS_TEST_OBJ_EQUAL(jnt(1), fused->at(0));
+    FOS_TEST_OBJ_EQUAL(jnt(5), fused->at(2));
+    ///////////////////// block/lift chains
+    TEST_ASSERT_EQUAL_STRING("start.lift", ops("5.block(6).lift(7)").c_str());
+    ///////////////////// toggles and counters
+    const RewriteStats *fold = Rewriter::stats(REWRITE_FOLD);
+    const long applied = fold->applied.load();
+    Rewriter::enable(REWRITE_FOLD, false);
+    TEST_ASSERT_EQUAL_STRING("start.fuse(plus.mult)", ops("5.plus(1).mult(2)").c_str());
+    TEST_ASSERT_EQUAL_INT(applied, fold->applied.load());
+    Rewriter::enable(REWRITE_FOLD, true);
+    TEST_ASSERT_EQUAL_STRING("start", ops("5.plus(1).mult(2)").c_str());
+    TEST_ASSERT_EQUAL_INT(applied + 1, fold->applied.load());
+    TEST_ASSERT_TRUE(Rewriter::stats_rec()->rec_get(vri(REWRITE_FOLD))->rec_get("enabled")->bool_value());
+    ///////////////////// ordering
+    const Rewriter ordered({Rewriter::fuse(), Rewriter::fold()});
+    FOS_TEST_FURI_EQUAL(ID(REWRITE_FOLD), std::get<0>(ordered._rewrites.front()));
+    const Function<BCode_p, BCode_p> identity = [](const BCode_p &bcode) { return bcode; };
+    FOS_TEST_EXCEPTION_CXX(
+        Rewriter({Rewrite(ID("/rewrite/a"), identity, {{ID("/rewrite/b")}, {}}),
+                  Rewrite(ID("/rewrite/b"), identity, {{ID("/rewrite/a")}, {}})}));
+  }
+
+  void test_compiled_closures() {
+    Closure closure(OBJ_PARSER("plus(1).mult(2)"));
+    for(FOS_INT_TYPE i = 0; i < 10; i++) {
+      const Obj_p compiled = closure.apply(jnt(i));
+      FOS_TEST_OBJ_EQUAL(OBJ_PARSER("plus(1).mult(2)")->apply(jnt(i)), compiled);
+    }
+    // both steps resolved once and then called natively
+    TEST_ASSERT_EQUAL_INT(2, closure.stats()->rec_get("native")->int_value());
+    TEST_ASSERT_EQUAL_INT(10, closure.stats()->rec_get("calls")->int_value());
+    TEST_ASSERT_EQUAL_INT(0, closure.stats()->rec_get("deopts")->int_value());
+    // a guard miss is resolved as the interpreter resolves it (and errors as it errors)
+    FOS_TEST_EXCEPTION_CXX(OBJ_PARSER("plus(1).mult(2)")->apply(real(1.5)));
+    FOS_TEST_EXCEPTION_CXX(closure.apply(real(1.5)));
+    const Obj_p hit = closure.apply(jnt(1));
+    FOS_TEST_OBJ_EQUAL(jnt(4), hit);
+    // objs are processed
+    TEST_ASSERT_EQUAL_INT(3, closure.apply(Obj::to_objs({jnt(1), jnt(2), jnt(3)}))->objs_value()->size());
+    // redefinitions invalidate the specialization
+    Compiler::inst_cache_clear();
+    TEST_ASSERT_EQUAL_INT(0, closure.stats()->rec_get("native")->int_value());
+    const Obj_p respecialized = closure.apply(jnt(2));
+    FOS_TEST_OBJ_EQUAL(jnt(6), respecialized);
+    TEST_ASSERT_EQUAL_INT(2, closure.stats()->rec_get("native")->int_value());
+    // code args are evaluated per lhs and gathers are processed
+    Closure args(OBJ_PARSER("plus(_).mult(2)"));
+    const Obj_p doubled = args.apply(jnt(3));
+    FOS_TEST_OBJ_EQUAL(jnt(12), doubled);
+    TEST_ASSERT_EQUAL_INT(1, args.stats()->rec_get("native")->int_value());
+    Closure gather(OBJ_PARSER("plus(1).count()"));
+    const Obj_p one = gather.apply(jnt(3));
+    FOS_TEST_OBJ_EQUAL(jnt(1), one);
+    const Obj_p three = gather.apply(Obj::to_objs({jnt(1), jnt(2), jnt(3)}));
+    FOS_TEST_OBJ_EQUAL(jnt(3), three);
+  }
+
+  void test_type_inference() {
+    const Unfolded unfolded;
+    Rewriter::enable(REWRITE_FUSE, false);
+    // start's ints flow through int plus (range int) to int mult
+    Processor inferred(OBJ_PARSER("{1,2,3}.plus(1).mult(2)"));
+    const Objs_p results = inferred.to_objs();
+    TEST_ASSERT_EQUAL_INT(3, results->objs_value()->size());
+    FOS_TEST_OBJ_EQUAL(jnt(8), results->objs_value()->back());
+    TEST_ASSERT_EQUAL_INT(6, inferred.type_checks_elided());
+    // a filter keeps the known type
+    Processor filtered(OBJ_PARSER("{1,2,3}.plus(1).is(gt(2))"));
+    TEST_ASSERT_EQUAL_INT(2, filtered.to_objs()->objs_value()->size());
+    TEST_ASSERT_EQUAL_INT(6, filtered.type_checks_elided());
+    // mixed base types are checked
+    Processor mixed(OBJ_PARSER("{1,2.5}.plus(_)"));
+    TEST_ASSERT_EQUAL_INT(2, mixed.to_objs()->objs_value()->size());
+    TEST_ASSERT_EQUAL_INT(0, mixed.type_checks_elided());
+    // as are all domains when debugging
+    PROCESSOR_FULL_TYPE_CHECKS = true;
+    Processor full(OBJ_PARSER("{1,2,3}.plus(1).mult(2)"));
+    FOS_TEST_OBJ_EQUAL(results, full.to_objs());
+    TEST_ASSERT_EQUAL_INT(0, full.type_checks_elided());
+    PROCESSOR_FULL_TYPE_CHECKS = false;
+    // the profile reports the skipped checks per inst
+    const Obj_p profile = Processor::compute(OBJ_PARSER("{1,2,3}.plus(1).mult(2).profile()"))->objs_value()->front();
+    TEST_ASSERT_TRUE(profile->toString().find("type_checks_elided") != string::npos);
+    Rewriter::enable(REWRITE_FUSE, true);
+  }
+
   FOS_RUN_TESTS( //
       FOS_RUN_TEST(test_monad_set); //
+      FOS_RUN_TEST(test_bulked_processor); //
+      FOS_RUN_TEST(test_batched_processor); //
+      FOS_RUN_TEST(test_parallel_processor); //
+      FOS_RUN_TEST(test_streaming_processor); //
+      FOS_RUN_TEST(test_combined_barriers); //
+      FOS_RUN_TEST(test_profiled_processor); //
+      FOS_RUN_TEST(test_rewritten_processor); //
+      FOS_RUN_TEST(test_compiled_closures); //
+      FOS_RUN_TEST(test_type_inference); //
       )
 }; // namespace fhatos
 
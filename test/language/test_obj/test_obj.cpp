@@ -30,6 +30,7 @@
 
 #include "../../../src/lang/obj.hpp"
 #include "../../../src/util/obj_helper.hpp"
+#include "../../../src/util/obj_codec.hpp"
 #include "../../test_fhatos.hpp"
 
 namespace fhatos {
@@ -462,6 +463,33 @@ namespace fhatos {
     FOS_TEST_IS_A(OType::INST, i2);
   }
 
+  void test_hash() {
+    const List<Pair<Obj_p, Obj_p>> equal_pairs = {
+        {jnt(1), jnt(1)},
+        {real(0.0f), real(-0.0f)},
+        {dool(true), dool(true)},
+        {str("fhat"), str("fhat")},
+        {vri("/a/b/c"), vri("/a/b/c")},
+        {lst({jnt(1), str("a")}), lst({jnt(1), str("a")})},
+        {rec({{"a", jnt(1)}, {"b", lst({jnt(2)})}}), rec({{"a", jnt(1)}, {"b", lst({jnt(2)})}})},
+        {Obj::to_noobj(), Obj::to_noobj()}};
+    for(const auto &[a, b]: equal_pairs) {
+      FOS_TEST_OBJ_EQUAL(a, b);
+      TEST_ASSERT_EQUAL(a->hash(), b->hash());
+    }
+    TEST_ASSERT_NOT_EQUAL(jnt(1)->hash(), jnt(2)->hash());
+    TEST_ASSERT_NOT_EQUAL(jnt(1)->hash(), real(1.0f)->hash());
+    TEST_ASSERT_NOT_EQUAL(str("/a")->hash(), vri("/a")->hash());
+    TEST_ASSERT_NOT_EQUAL(lst({jnt(1), jnt(2)})->hash(), lst({jnt(2), jnt(1)})->hash());
+    // mutated polys are rehashed
+    const Rec_p r = rec({{"a", jnt(1)}});
+    const size_t before = r->hash();
+    r->rec_set("b", jnt(2));
+    TEST_ASSERT_NOT_EQUAL(before, r->hash());
+    TEST_ASSERT_EQUAL(rec({{"a", jnt(1)}, {"b", jnt(2)}})->hash(), r->hash());
+    TEST_ASSERT_EQUAL_INT(2, r->rec_get("b")->int_value());
+  }
+
   void test_serialization() {
     const List<Obj_p> objs = {
         Obj::to_noobj(),
@@ -483,6 +511,30 @@ namespace fhatos {
     }
   }
 
+  void test_binary_codec() {
+    const List<Obj_p> objs = {
+        Obj::to_noobj(), dool(false), Obj::to_int(0), Obj::to_int(-453), Obj::to_int(2147483647),
+        Obj::to_real(12.035f), Obj::to_str(""), Obj::to_str("fhatos"), Obj::to_uri("aaaa"),
+        Obj::to_int(12, INT_FURI, id_p("/obj/codec/x")),
+        Obj::to_lst({jnt(1), jnt(7), str("abc"), vri("hello/fhat/aus")}),
+        Obj::to_rec({{"a", jnt(2)}, {"b", Obj::to_lst({vri("a"), vri("a"), Obj::to_rec({{vri("a"), real(1.5f)}})})}}),
+        Obj::to_objs({jnt(1), str("two")})};
+    for(const auto &obj_a: objs) {
+      const BObj_p bobj = ObjCodec::encode(obj_a, Codec::BINARY);
+      TEST_ASSERT_TRUE(ObjCodec::is_binary(bobj));
+      const Obj_p obj_b = ObjCodec::decode(bobj);
+      FOS_TEST_OBJ_EQUAL(obj_a, obj_b);
+      if(obj_a->vid)
+        TEST_ASSERT_EQUAL_STRING(obj_a->vid->toString().c_str(), obj_b->vid->toString().c_str());
+      // text payloads are still decoded
+      FOS_TEST_OBJ_EQUAL(obj_a, ObjCodec::decode(ObjCodec::encode(obj_a, Codec::TEXT)));
+    }
+    // repeated uris are interned
+    const Obj_p uris = Obj::to_lst({vri("/a/long/uri"), vri("/a/long/uri"), vri("/a/long/uri")});
+    TEST_ASSERT_LESS_THAN_INT(ObjCodec::encode(uris, Codec::TEXT)->first, ObjCodec::encode(uris, Codec::BINARY)->first);
+    FOS_TEST_EXCEPTION_CXX(ObjCodec::decode(make_shared<BObj>(3, (fbyte *) "\xF0\x01\x04")));
+  }
+
   FOS_RUN_TESTS( //
       FOS_RUN_TEST(test_operator_equals); //
       FOS_RUN_TEST(test_lock); //
@@ -497,7 +549,9 @@ namespace fhatos {
       FOS_RUN_TEST(test_rec_nested_set_get); //
       FOS_RUN_TEST(test_rec_nested_set_get_with_components); //
       FOS_RUN_TEST(test_inst); //
+      FOS_RUN_TEST(test_hash); //
       FOS_RUN_TEST(test_serialization); //
+      FOS_RUN_TEST(test_binary_codec); //
   )
 }; // namespace fhatos
 
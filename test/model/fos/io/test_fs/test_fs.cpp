@@ -39,6 +39,12 @@ namespace fhatos {
     return test_structure;
   }
 
+  Structure_p get_or_create_binary_structure() {
+    Structure_p test_structure = std::make_shared<FS>(
+        "/fs/xyz/#", id_p("/sys/test"), Obj::to_rec({{"root", vri("/fs_binary")}, {"codec", vri("binary")}}));
+    return test_structure;
+  }
+
   void test_generic_clear() { GenericStructureTest(get_or_create_structure()).test_clear(); }
 
   void test_generic_write() { GenericStructureTest(get_or_create_structure()).test_write(); }
@@ -57,6 +63,13 @@ namespace fhatos {
 
   void test_generic_q_doc() { GenericStructureTest(get_or_create_structure()).test_q_doc(); }
 
+  void test_binary_codec() {
+    GenericStructureTest(get_or_create_binary_structure()).test_write();
+    GenericStructureTest(get_or_create_binary_structure()).test_mono_embedding();
+    GenericStructureTest(get_or_create_binary_structure()).test_lst_embedding();
+    GenericStructureTest(get_or_create_binary_structure()).test_rec_embedding();
+  }
+
   FOS_RUN_TESTS( //
       FOS_RUN_TEST(test_generic_clear); //
       FOS_RUN_TEST(test_generic_write); //
@@ -67,6 +80,7 @@ namespace fhatos {
       FOS_RUN_TEST(test_generic_rec_embedding); //
       FOS_RUN_TEST(test_generic_q_sub); //
       FOS_RUN_TEST(test_generic_q_doc); //
+      FOS_RUN_TEST(test_binary_codec); //
   );
 } // namespace fhatos
 
@@ -53,6 +53,59 @@ namespace fhatos {
 
   void test_generic_q_doc() { GenericStructureTest(get_or_create_structure()).test_q_doc(); }
 
+  void test_shared_heap() {
+    const Structure_p shared = Heap<>::create("/xyz_shared/#", id_p("/sys/test_shared"), rec({{"share", dool(true)}}));
+    const Structure_p cloned = Heap<>::create("/xyz_cloned/#", id_p("/sys/test_cloned"), rec({{"share", dool(false)}}));
+    Router::singleton()->attach(shared);
+    Router::singleton()->attach(cloned);
+    for(const auto &[s, prefix]: List<Pair<Structure_p, string>>{{shared, "/xyz_shared/"}, {cloned, "/xyz_cloned/"}}) {
+      s->write(fURI(prefix + "a"), rec({{"b", jnt(1)}, {"c", lst({jnt(2), jnt(3)})}}), true);
+      s->write(fURI(prefix + "l"), lst({jnt(1)}), true);
+      const Obj_p a1 = s->read(fURI(prefix + "a"));
+      const Obj_p l1 = s->read(fURI(prefix + "l"));
+      /// shared heaps hand out the same obj, cloning heaps a copy
+      TEST_ASSERT_EQUAL(s == shared, a1.get() == s->read(fURI(prefix + "a")).get());
+      /// mutations are copy-on-write (earlier reads are unchanged)
+      s->write(fURI(prefix + "a/b"), jnt(2), true);
+      s->append(fURI(prefix + "l"), jnt(2));
+      FOS_TEST_OBJ_EQUAL(jnt(1), a1->rec_get("b"));
+      FOS_TEST_OBJ_EQUAL(lst({jnt(1)}), l1);
+      FOS_TEST_OBJ_EQUAL(jnt(2), s->read(fURI(prefix + "a/b")));
+      FOS_TEST_OBJ_EQUAL(lst({jnt(1), jnt(2)}), s->read(fURI(prefix + "l")));
+      FOS_TEST_OBJ_EQUAL(lst({jnt(2), jnt(3)}), s->read(fURI(prefix + "a/c")));
+    }
+    ROUTER_WRITE(*shared->vid, Obj::to_noobj(), true);
+    ROUTER_WRITE(*cloned->vid, Obj::to_noobj(), true);
+    Router::singleton()->loop();
+  }
+
+  void test_heap_backends() {
+    const Structure_p map = Heap<>::create("/xyz_map/#", id_p("/sys/test_map"), rec({{"backend", vri("map")}}));
+    const Structure_p trie = Heap<>::create("/xyz_trie/#", id_p("/sys/test_trie"), rec({{"backend", vri("trie")}}));
+    Router::singleton()->attach(map);
+    Router::singleton()->attach(trie);
+    for(const auto &[s, prefix]: List<Pair<Structure_p, string>>{{map, "/xyz_map/"}, {trie, "/xyz_trie/"}}) {
+      for(const char *id: {"a", "a/b", "a/c", "a/b/c", "a/b/d", "b/c", "a-b"}) {
+        s->write(fURI(prefix + id), vri(id), true);
+      }
+      FOS_TEST_OBJ_EQUAL(vri("a/b"), s->read(fURI(prefix + "a/b")));
+      FOS_TEST_OBJ_EQUAL(Obj::to_noobj(), s->read(fURI(prefix + "a/x")));
+      TEST_ASSERT_EQUAL(7, s->read(fURI(prefix + "#"))->objs_value()->size());
+      TEST_ASSERT_EQUAL(5, s->read(fURI(prefix + "a/#"))->objs_value()->size());
+      TEST_ASSERT_EQUAL(2, s->read(fURI(prefix + "a/b/+"))->objs_value()->size());
+      TEST_ASSERT_EQUAL(2, s->read(fURI(prefix + "+/c"))->objs_value()->size());
+      TEST_ASSERT_TRUE(s->has(fURI(prefix + "+/b/+")));
+      TEST_ASSERT_TRUE(s->has(fURI(prefix + "a-b")));
+      TEST_ASSERT_FALSE(s->has(fURI(prefix + "+/x")));
+      s->write(fURI(prefix + "a/b/#"), Obj::to_noobj(), true);
+      TEST_ASSERT_EQUAL(2, s->read(fURI(prefix + "a/#"))->objs_value()->size());
+      TEST_ASSERT_FALSE(s->has(fURI(prefix + "a/b/+")));
+    }
+    ROUTER_WRITE(*map->vid, Obj::to_noobj(), true);
+    ROUTER_WRITE(*trie->vid, Obj::to_noobj(), true);
+    Router::singleton()->loop();
+  }
+
   FOS_RUN_TESTS( //
       FOS_RUN_TEST(test_generic_clear); //
       FOS_RUN_TEST(test_generic_write); //
@@ -63,6 +116,8 @@ namespace fhatos {
       FOS_RUN_TEST(test_generic_rec_embedding); //
       FOS_RUN_TEST(test_generic_q_sub); //
       FOS_RUN_TEST(test_generic_q_doc); //
+      FOS_RUN_TEST(test_shared_heap); //
+      FOS_RUN_TEST(test_heap_backends); //
   );
 
 } // namespace fhatos
@@ -58,6 +58,21 @@ namespace fhatos {
     FOS_TEST_OBJ_EQUAL(jnt(95), PROCESS("*/router/abc"));
   }
 
+  void test_structure_index() {
+    Router::singleton()->attach(Heap<>::create("/idx/a/#", id_p("/mnt/idx_a")));
+    Router::singleton()->attach(Heap<>::create("/idx/+/b/#", id_p("/mnt/idx_b")));
+    Router::singleton()->attach(Heap<>::create("/idx/c", id_p("/mnt/idx_c")));
+    FOS_TEST_OBJ_EQUAL(jnt(1), PROCESS("/idx/a/x -> 1"));
+    FOS_TEST_OBJ_EQUAL(jnt(2), PROCESS("/idx/z/b/y -> 2"));
+    FOS_TEST_OBJ_EQUAL(jnt(3), PROCESS("/idx/c -> 3"));
+    FOS_TEST_OBJ_EQUAL(jnt(1), PROCESS("*/idx/a/x"));
+    FOS_TEST_OBJ_EQUAL(jnt(2), PROCESS("*/idx/z/b/y"));
+    FOS_TEST_OBJ_EQUAL(jnt(3), PROCESS("*/idx/c"));
+    FOS_TEST_ERROR("/idx/a/b/y -> 4"); // crosses multiple structures
+    FOS_TEST_ERROR("/idx/d -> 5"); // no mounted structure
+    TEST_ASSERT_TRUE(PROCESS("*/idx/z/c")->is_noobj());
+  }
+
   // COMMENTED OUT
   void test_transient_write() {
     PROCESS("/router/abc1 -> |(plus(10).to(/router/bcd))");
@@ -97,6 +112,7 @@ namespace fhatos {
       FOS_RUN_TEST(test_router_config); //
      // FOS_RUN_TEST(test_router_attach_detach); //
       FOS_RUN_TEST(test_retain_write); //
+      FOS_RUN_TEST(test_structure_index); //
      // FOS_RUN_TEST(test_transient_write); //
      // FOS_RUN_TEST(test_lock_query_processor); //
       )